@@ -51,6 +51,13 @@ basic_ptr::basic_ptr(basic_ptr &&from) noexcept : alloc{std::move(from.alloc)},
     from.reset();
 }
 
+basic_ptr::basic_ptr(owned_bytes &&from) noexcept : basic_ptr{from.get_deleter().alloc} {
+    dimension = from.get_deleter().dimension;
+    memory = from.release();
+    if(memory == nullptr)
+        dimension = 0;
+}
+
 void basic_ptr::free(){
     if(memory != nullptr){
 		raw_deallocate(memory, dimension);
@@ -82,6 +89,14 @@ basic_ptr &basic_ptr::operator=(basic_ptr &&ref){
 }
 
 void basic_ptr::reallocate(std::size_t dim){
+    if(memory != nullptr && dim > 0){
+        expandable_resource *exp = dynamic_cast<expandable_resource *>(alloc);
+        if(exp != nullptr){
+            memory = static_cast<byte *>(exp->reallocate(memory, dimension, dim));
+            dimension = dim;
+            return;
+        }
+    }
     byte *newm = raw_allocate(dim);
     size_t mindim = dim > dimension ? dimension : dim;
     if(memory != nullptr)
@@ -92,6 +107,24 @@ void basic_ptr::reallocate(std::size_t dim){
 }
 
 void basic_ptr::reallocate_reverse(std::size_t dim){
+    if(memory != nullptr && dim > 0){
+        expandable_resource *exp = dynamic_cast<expandable_resource *>(alloc);
+        if(exp != nullptr){
+            if(dim > dimension){
+                if(exp->try_expand(memory, dimension, dim)){
+                    std::memmove(memory + (dim - dimension), memory, dimension);
+                    dimension = dim;
+                    return;
+                }
+            }
+            else{
+                std::memmove(memory, memory + (dimension - dim), dim);
+                memory = static_cast<byte *>(exp->reallocate(memory, dimension, dim));
+                dimension = dim;
+                return;
+            }
+        }
+    }
     byte *newm = raw_allocate(dim);
     const byte *from = nullptr;
     byte *to = nullptr;
@@ -142,6 +175,11 @@ void basic_ptr::exp_fit_reverse(std::size_t fit){
         reallocate_reverse(grown);
 }
 
+owned_bytes basic_ptr::release() noexcept{
+    pmr_deleter del{alloc, dimension};
+    return owned_bytes{leave(), del};
+}
+
 byte* basic_ptr::leave() noexcept{
     byte *ret = nullptr;
 	std::swap(ret, memory);
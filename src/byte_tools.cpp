@@ -18,6 +18,7 @@
 
 #include <strsuite/encmetric/byte_tools.hpp>
 #include <cstring>
+#include <cstdint>
 
 bool sts::compare(const sts::byte *a, const sts::byte *b, std::size_t nsiz) noexcept{
 	return std::memcmp(a, b, nsiz) == 0;
@@ -29,3 +30,19 @@ void sts::copy_bytes(sts::byte *a, const sts::byte *b, std::size_t nsiz) noexcep
 void sts::move_bytes(sts::byte *a, const sts::byte *b, std::size_t nsiz) noexcept{
 	std::memmove(a, b, nsiz);
 }
+
+std::size_t sts::ascii_prefix(const sts::byte *b, std::size_t siz) noexcept{
+	constexpr std::uint64_t high = 0x8080808080808080ull;
+	std::size_t i = 0;
+	while(i + 8 <= siz){
+		std::uint64_t w;
+		std::memcpy(&w, b + i, 8);
+		if((w & high) != 0)
+			break;
+		i += 8;
+	}
+	while(i < siz && (b[i] & sts::byte{0x80}) == sts::byte{0})
+		i++;
+	return i;
+}
+
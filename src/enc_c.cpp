@@ -36,3 +36,7 @@ template class sts::tchar_pt<sts::UTF32SYS>;
 template class sts::const_tchar_pt<sts::UTF32SYS>;
 template class sts::adv_string_view<sts::UTF32SYS>;
 template class sts::adv_string<sts::UTF32SYS>;
+
+static_assert(std::is_trivially_copyable_v<sts::adv_string_view<sts::UTF8>>);
+static_assert(std::is_trivially_copyable_v<sts::compact_view<sts::UTF8>>);
+static_assert(sizeof(sts::compact_view<sts::UTF8>) == 3 * sizeof(void *));
@@ -0,0 +1,156 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <strsuite/io/newline_scan.hpp>
+#include <cstring>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using sts::byte;
+
+namespace{
+
+/*
+ * First two bytes unit equal to u at an even offset not lesser than i
+ */
+size_t find_unit16(const byte *b, size_t i, size_t siz, const byte *u) noexcept{
+#if defined(__SSE2__)
+    std::uint16_t val;
+    std::memcpy(&val, u, 2);
+    const __m128i pat = _mm_set1_epi16(static_cast<short>(val));
+    while(i + 16 <= siz){
+        __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(blk, pat));
+        if(mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        i += 16;
+    }
+#endif
+    for(; i + 2 <= siz; i += 2){
+        if(b[i] == u[0] && b[i + 1] == u[1])
+            return i;
+    }
+    return siz;
+}
+
+/*
+ * First byte equal to x or y
+ */
+size_t find_either8(const byte *b, size_t i, size_t siz, byte x, byte y) noexcept{
+#if defined(__SSE2__)
+    const __m128i px = _mm_set1_epi8(static_cast<char>(x));
+    const __m128i py = _mm_set1_epi8(static_cast<char>(y));
+    while(i + 16 <= siz){
+        __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(blk, px), _mm_cmpeq_epi8(blk, py)));
+        if(mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        i += 16;
+    }
+#endif
+    for(; i < siz; i++){
+        if(b[i] == x || b[i] == y)
+            return i;
+    }
+    return siz;
+}
+
+/*
+ * First two bytes unit equal to x or y at an even offset
+ */
+size_t find_either16(const byte *b, size_t i, size_t siz, const byte *x, const byte *y) noexcept{
+#if defined(__SSE2__)
+    std::uint16_t vx, vy;
+    std::memcpy(&vx, x, 2);
+    std::memcpy(&vy, y, 2);
+    const __m128i px = _mm_set1_epi16(static_cast<short>(vx));
+    const __m128i py = _mm_set1_epi16(static_cast<short>(vy));
+    while(i + 16 <= siz){
+        __m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi16(blk, px), _mm_cmpeq_epi16(blk, py)));
+        if(mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        i += 16;
+    }
+#endif
+    for(; i + 2 <= siz; i += 2){
+        if(std::memcmp(b + i, x, 2) == 0 || std::memcmp(b + i, y, 2) == 0)
+            return i;
+    }
+    return siz;
+}
+
+}
+
+size_t sts::find_newline(const byte *b, size_t siz, const byte *nl, size_t nls, size_t unit) noexcept{
+    if(nls == 0 || siz < nls)
+        return siz;
+    const size_t last = siz - nls;
+    size_t i = 0;
+    while(i <= last){
+        size_t off;
+        if(unit == 1){
+            const void *found = std::memchr(b + i, static_cast<int>(nl[0]), last + 1 - i);
+            if(found == nullptr)
+                return siz;
+            off = static_cast<size_t>(static_cast<const byte *>(found) - b);
+        }
+        else if(unit == 2 && nls >= 2){
+            off = find_unit16(b, i, last + 2, nl);
+            if(off > last)
+                return siz;
+        }
+        else{
+            if(std::memcmp(b + i, nl, nls) == 0)
+                return i;
+            i += unit;
+            continue;
+        }
+        if(std::memcmp(b + off, nl, nls) == 0)
+            return off;
+        i = off + unit;
+    }
+    return siz;
+}
+
+sts::newline_match sts::find_any_newline(const byte *b, size_t siz, const byte *lf, const byte *cr, size_t unit) noexcept{
+    size_t off = siz;
+    if(unit == 1)
+        off = find_either8(b, 0, siz, lf[0], cr[0]);
+    else if(unit == 2)
+        off = find_either16(b, 0, siz, lf, cr);
+    else{
+        for(size_t i=0; i + unit <= siz; i += unit){
+            if(std::memcmp(b + i, lf, unit) == 0 || std::memcmp(b + i, cr, unit) == 0){
+                off = i;
+                break;
+            }
+        }
+    }
+    if(off + unit > siz)
+        return newline_match{siz, 0};
+    if(std::memcmp(b + off, lf, unit) == 0)
+        return newline_match{off, unit};
+    if(off + 2 * unit > siz)
+        return newline_match{off, 0};
+    if(std::memcmp(b + off + unit, lf, unit) == 0)
+        return newline_match{off, 2 * unit};
+    return newline_match{off, unit};
+}
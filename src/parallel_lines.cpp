@@ -0,0 +1,98 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <strsuite/io/parallel_lines.hpp>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+std::vector<sts::byte_range> sts::split_at_newlines(const byte *b, size_t siz, const byte *nl, size_t nls, size_t head, size_t nchunks){
+    std::vector<byte_range> ret{};
+    size_t pos = 0;
+    if(nchunks > 1 && head > 0 && nls > 0){
+        const size_t target = siz / nchunks;
+        for(size_t k=1; k<nchunks && pos < siz; k++){
+            size_t p = k * target > pos ? k * target : pos;
+            p = (p + head - 1) / head * head;
+            if(p >= siz)
+                break;
+            size_t off = find_newline(b + p, siz - p, nl, nls, head);
+            if(off == siz - p)
+                break;
+            size_t end = p + off + nls;
+            ret.push_back(byte_range{pos, end});
+            pos = end;
+        }
+    }
+    if(pos < siz)
+        ret.push_back(byte_range{pos, siz});
+    return ret;
+}
+
+size_t sts::pool_size(size_t nthreads) noexcept{
+    if(nthreads > 0)
+        return nthreads;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : hw;
+}
+
+void sts::parallel_run(size_t ntasks, size_t nthreads, const std::function<void(size_t)> &task){
+    nthreads = pool_size(nthreads);
+    if(nthreads > ntasks)
+        nthreads = ntasks;
+    if(nthreads <= 1){
+        for(size_t i=0; i<ntasks; i++)
+            task(i);
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::atomic<bool> stop{false};
+    std::exception_ptr exc{};
+    std::mutex exc_lock{};
+    auto worker = [&](){
+        size_t i;
+        while(!stop.load(std::memory_order_relaxed) && (i = next.fetch_add(1, std::memory_order_relaxed)) < ntasks){
+            try{
+                task(i);
+            }
+            catch(...){
+                std::lock_guard<std::mutex> lck{exc_lock};
+                if(!exc)
+                    exc = std::current_exception();
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    std::vector<std::thread> pool{};
+    pool.reserve(nthreads - 1);
+    try{
+        for(size_t t=1; t<nthreads; t++)
+            pool.emplace_back(worker);
+    }
+    catch(...){
+        stop.store(true, std::memory_order_relaxed);
+        for(std::thread &th : pool)
+            th.join();
+        throw;
+    }
+    worker();
+    for(std::thread &th : pool)
+        th.join();
+    if(exc)
+        std::rethrow_exception(exc);
+}
@@ -0,0 +1,226 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/resources.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+using namespace sts;
+
+void *expandable_resource::do_reallocate(void *p, std::size_t old, std::size_t nsiz, std::size_t align){
+    if(p == nullptr)
+        return allocate(nsiz, align);
+    if(do_try_expand(p, old, nsiz, align))
+        return p;
+    void *ret = allocate(nsiz, align);
+    std::memcpy(ret, p, old < nsiz ? old : nsiz);
+    deallocate(p, old, align);
+    return ret;
+}
+
+//------------------------------
+
+static bool malloc_align(std::size_t align) noexcept{
+    return align <= alignof(std::max_align_t);
+}
+
+void *malloc_resource::do_allocate(std::size_t siz, std::size_t align){
+    if(siz == 0)
+        siz = 1;
+    void *ret = nullptr;
+    if(malloc_align(align))
+        ret = std::malloc(siz);
+    else{
+        #if defined(_MSC_VER)
+        ret = _aligned_malloc(siz, align);
+        #else
+        ret = std::aligned_alloc(align, ((siz + align - 1) / align) * align);
+        #endif
+    }
+    if(ret == nullptr)
+        throw std::bad_alloc{};
+    return ret;
+}
+
+void malloc_resource::do_deallocate(void *p, std::size_t, std::size_t align){
+    #if defined(_MSC_VER)
+    if(!malloc_align(align)){
+        _aligned_free(p);
+        return;
+    }
+    #else
+    (void)align;
+    #endif
+    std::free(p);
+}
+
+bool malloc_resource::do_is_equal(const std::pmr::memory_resource &oth) const noexcept{
+    return dynamic_cast<const malloc_resource *>(&oth) != nullptr;
+}
+
+bool malloc_resource::do_try_expand([[maybe_unused]] void *p, [[maybe_unused]] std::size_t old, [[maybe_unused]] std::size_t nsiz, std::size_t align) noexcept{
+    if(!malloc_align(align))
+        return false;
+    #if defined(__GLIBC__)
+    return malloc_usable_size(p) >= nsiz;
+    #elif defined(_MSC_VER)
+    return _expand(p, nsiz == 0 ? 1 : nsiz) != nullptr;
+    #else
+    return nsiz <= old;
+    #endif
+}
+
+void *malloc_resource::do_reallocate(void *p, std::size_t old, std::size_t nsiz, std::size_t align){
+    if(!malloc_align(align))
+        return expandable_resource::do_reallocate(p, old, nsiz, align);
+    /*
+     * Big blocks can be moved by remapping pages instead of copying them
+     */
+    void *ret = std::realloc(p, nsiz == 0 ? 1 : nsiz);
+    if(ret == nullptr)
+        throw std::bad_alloc{};
+    return ret;
+}
+
+malloc_resource *sts::get_malloc_resource() noexcept{
+    static malloc_resource res{};
+    return &res;
+}
+
+//------------------------------
+
+void container_resource::add(const void *p, std::unique_ptr<holder_base> h){
+    std::lock_guard<std::mutex> lock{mtx};
+    owned.emplace(p, std::move(h));
+}
+
+void *container_resource::do_allocate(std::size_t siz, std::size_t align){
+    return upstream->allocate(siz, align);
+}
+
+void container_resource::do_deallocate(void *p, std::size_t siz, std::size_t align){
+    std::unique_ptr<holder_base> h;
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        auto it = owned.find(p);
+        if(it != owned.end()){
+            h = std::move(it->second);
+            owned.erase(it);
+        }
+    }
+    /*
+     * The container is destroyed outside the lock
+     */
+    if(!h)
+        upstream->deallocate(p, siz, align);
+}
+
+bool container_resource::do_is_equal(const std::pmr::memory_resource &oth) const noexcept{
+    return this == &oth;
+}
+
+/*
+ * Never destroyed, strings adopting containers could be destroyed after static objects
+ */
+container_resource *sts::get_container_resource() noexcept{
+    static container_resource *res = new container_resource{};
+    return res;
+}
+
+//------------------------------
+
+monotonic_expand_resource::monotonic_expand_resource(std::size_t initial_dim, std::pmr::memory_resource *up) : upstream{up == nullptr ? std::pmr::get_default_resource() : up}, chunks{nullptr}, cur{nullptr}, lim{nullptr}, last{nullptr}, next_dim{initial_dim == 0 ? 1024 : initial_dim}, used{0}, reserved{0} {}
+
+monotonic_expand_resource::~monotonic_expand_resource(){
+    release();
+}
+
+void monotonic_expand_resource::release() noexcept{
+    while(chunks != nullptr){
+        chunk_header *prev = chunks->prev;
+        upstream->deallocate(chunks, sizeof(chunk_header) + chunks->dim, alignof(std::max_align_t));
+        chunks = prev;
+    }
+    cur = nullptr;
+    lim = nullptr;
+    last = nullptr;
+    used = 0;
+    reserved = 0;
+}
+
+void monotonic_expand_resource::new_chunk(std::size_t min_dim){
+    std::size_t dim = next_dim;
+    while(dim < min_dim)
+        dim *= 2;
+    void *mem = upstream->allocate(sizeof(chunk_header) + dim, alignof(std::max_align_t));
+    chunk_header *head = static_cast<chunk_header *>(mem);
+    head->prev = chunks;
+    head->dim = dim;
+    chunks = head;
+    cur = reinterpret_cast<byte *>(head + 1);
+    lim = cur + dim;
+    last = nullptr;
+    next_dim = dim * 2;
+    reserved += dim;
+}
+
+static std::size_t align_padding(const byte *p, std::size_t align) noexcept{
+    std::size_t mis = reinterpret_cast<std::uintptr_t>(p) % align;
+    return mis == 0 ? 0 : align - mis;
+}
+
+void *monotonic_expand_resource::do_allocate(std::size_t siz, std::size_t align){
+    std::size_t pad = align_padding(cur, align);
+    if(cur == nullptr || static_cast<std::size_t>(lim - cur) < pad + siz){
+        new_chunk(siz + align);
+        pad = align_padding(cur, align);
+    }
+    last = cur + pad;
+    cur = last + siz;
+    used += siz;
+    return last;
+}
+
+void monotonic_expand_resource::do_deallocate(void *p, std::size_t siz, std::size_t){
+    if(p == last && last + siz == cur){
+        cur = last;
+        last = nullptr;
+        used -= siz;
+    }
+}
+
+bool monotonic_expand_resource::do_try_expand(void *p, std::size_t old, std::size_t nsiz, std::size_t) noexcept{
+    if(p == nullptr || p != last || last + old != cur)
+        return false;
+    if(static_cast<std::size_t>(lim - last) < nsiz)
+        return false;
+    cur = last + nsiz;
+    used = used + nsiz - old;
+    return true;
+}
+
+bool monotonic_expand_resource::do_is_equal(const std::pmr::memory_resource &oth) const noexcept{
+    return this == &oth;
+}
@@ -0,0 +1,48 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/shared_string.hpp>
+
+using namespace sts;
+
+shared_block::shared_block(std::pmr::memory_resource *all, size_t d, basic_ptr own) noexcept : refs{1}, alloc{all}, dim{d}, owned{std::move(own)} {}
+
+shared_block *shared_block::create(const byte *data, size_t siz, std::pmr::memory_resource *all){
+    if(all == nullptr)
+        all = std::pmr::get_default_resource();
+    size_t tot = sizeof(shared_block) + siz;
+    void *mem = all->allocate(tot, alignof(shared_block));
+    shared_block *ret = ::new(mem) shared_block{all, tot, basic_ptr{all}};
+    if(siz > 0)
+        copy_bytes(reinterpret_cast<byte *>(ret + 1), data, siz);
+    return ret;
+}
+
+shared_block *shared_block::adopt(basic_ptr own){
+    std::pmr::memory_resource *all = own.get_allocator();
+    void *mem = all->allocate(sizeof(shared_block), alignof(shared_block));
+    return ::new(mem) shared_block{all, sizeof(shared_block), std::move(own)};
+}
+
+void shared_block::release() noexcept{
+    if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        std::pmr::memory_resource *all = alloc;
+        size_t tot = dim;
+        this->~shared_block();
+        all->deallocate(this, tot, alignof(shared_block));
+    }
+}
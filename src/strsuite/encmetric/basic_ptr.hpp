@@ -17,12 +17,29 @@
     along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
 */
 #include <new>
+#include <memory>
 #include <memory_resource>
 #include <cstring>
 #include <strsuite/encmetric/base.hpp>
+#include <strsuite/encmetric/resources.hpp>
 
 namespace sts{
 
+/*
+ * Deallocates a memory block released by a basic_ptr, it remembers both its resource and its dimension
+ */
+struct pmr_deleter{
+    std::pmr::memory_resource *alloc = nullptr;
+    std::size_t dimension = 0;
+
+    void operator()(byte *b) const noexcept{
+        if(b != nullptr && alloc != nullptr)
+            alloc->deallocate(b, dimension);
+    }
+};
+
+using owned_bytes = std::unique_ptr<byte[], pmr_deleter>;
+
 /*
     A basic unique_ptr that uses memory resources
 */
@@ -41,6 +58,10 @@ class basic_ptr{
 		explicit basic_ptr(const byte *pt, std::size_t dim, std::pmr::memory_resource *all = std::pmr::get_default_resource());
 		basic_ptr(const basic_ptr &) = delete;
 		basic_ptr(basic_ptr &&from) noexcept;
+		/*
+		 * Takes a block previously released by a basic_ptr
+		 */
+		explicit basic_ptr(owned_bytes &&from) noexcept;
 		void free();
 		~basic_ptr();
 		void swap(basic_ptr &sw) noexcept;
@@ -49,6 +70,8 @@ class basic_ptr{
 
         /*
          * aligned with the first byte of memory
+         *
+         * If the allocator is an expandable_resource then the memory block is resized in place when possible
          */
 		void reallocate(std::size_t dim);
         /*
@@ -64,6 +87,10 @@ class basic_ptr{
 		void exp_fit(std::size_t fit);
         void exp_fit_reverse(std::size_t fit);
 		byte* leave() noexcept;
+		/*
+		 * Like leave, but the returned pointer knows how to deallocate itself
+		 */
+		owned_bytes release() noexcept;
 
 		std::pmr::memory_resource *get_allocator() const noexcept{
 			return alloc;
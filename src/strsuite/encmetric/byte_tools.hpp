@@ -43,6 +43,10 @@ inline namespace literals{
 bool compare(const byte *a, const byte *b, std::size_t nsiz) noexcept;
 void copy_bytes(byte *to, const byte *from, std::size_t siz) noexcept;
 void move_bytes(byte *to, const byte *from, std::size_t siz) noexcept;
+/*
+    Number of leading bytes lesser than 0x80, tested 8 bytes at a time
+*/
+std::size_t ascii_prefix(const byte *b, std::size_t siz) noexcept;
 
 /*
     Create a bit mask of type RET with ones at positions oth.
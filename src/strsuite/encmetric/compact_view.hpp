@@ -0,0 +1,95 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <compare>
+#include <cstring>
+#include <strsuite/encmetric/enc_string.hpp>
+
+namespace sts{
+
+/*
+ * Smaller version of adv_string_view, useful when you need to store a lot of views.
+ *
+ * It's trivially copyable and it stores only pointer, size and length (plus the encoding for
+ * WIDE encodings). If the view is built from raw bytes its length is computed the first time
+ * length() is called, so concurrent calls of length() on the same object should be avoided.
+ */
+template<general_enctype T>
+class compact_view{
+    private:
+        static constexpr size_t unknown_len = static_cast<size_t>(-1);
+        const byte *ptr;
+        size_t siz;
+        mutable size_t len;
+        [[no_unique_address]] EncMetric_info<T> format;
+    public:
+        using ctype = typename T::ctype;
+
+        explicit compact_view(EncMetric_info<T> f) noexcept : ptr{nullptr}, siz{0}, len{0}, format{f} {}
+        compact_view() noexcept requires strong_enctype<T> : compact_view{EncMetric_info<T>{}} {}
+        explicit compact_view(const EncMetric<ctype> *f) noexcept requires widenc<T> : compact_view{EncMetric_info<T>{f}} {}
+        /*
+         * Doesn't verify the string
+         */
+        compact_view(const byte *b, size_t s, EncMetric_info<T> f) noexcept : ptr{b}, siz{s}, len{unknown_len}, format{f} {}
+        compact_view(const byte *b, size_t s) noexcept requires strong_enctype<T> : compact_view{b, s, EncMetric_info<T>{}} {}
+        compact_view(const adv_string_view<T> &v) noexcept : ptr{v.data()}, siz{v.size()}, len{v.length()}, format{v.raw_format()} {}
+
+        const byte *data() const noexcept{ return ptr;}
+        const char *raw() const noexcept{ return reinterpret_cast<const char *>(ptr);}
+        size_t size() const noexcept{ return siz;}
+        bool empty() const noexcept{ return siz == 0;}
+        bool length_known() const noexcept{ return len != unknown_len;}
+        size_t length() const;
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+
+        adv_string_view<T> view() const{ return direct_build(const_tchar_pt<T>{ptr, format}, length(), siz);}
+        operator adv_string_view<T>() const{ return view();}
+
+        /*
+         * Same byte-only ordering of adv_string_view
+         */
+        std::weak_ordering operator<=>(const compact_view &c) const noexcept{
+            size_t m = siz < c.siz ? siz : c.siz;
+            int res = m == 0 ? 0 : std::memcmp(ptr, c.ptr, m);
+            if(res != 0)
+                return res < 0 ? std::weak_ordering::less : std::weak_ordering::greater;
+            return siz <=> c.siz;
+        }
+        bool operator==(const compact_view &c) const noexcept{
+            return siz == c.siz && (siz == 0 || std::memcmp(ptr, c.ptr, siz) == 0);
+        }
+};
+
+template<general_enctype T>
+size_t compact_view<T>::length() const{
+    if(len == unknown_len){
+        if(format.is_fixed())
+            len = siz / format.min_bytes();
+        else
+            len = deduce_lens(const_tchar_pt<T>{ptr, format}, siz).len;
+    }
+    return len;
+}
+
+template<general_enctype T>
+compact_view<T> make_compact(const adv_string_view<T> &v) noexcept{
+    return compact_view<T>{v};
+}
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <type_traits>
+#include <strsuite/encmetric/dynstring.hpp>
+
+namespace sts{
+
+/*
+ * Lazy concatenation of strings and characters
+ *
+ *     adv_string<UTF8> key = a + u8"/"_asv + b + '#'_uni + c;
+ *
+ * builds nothing until the expression is converted to an adv_string, then the final size is computed
+ * and the string is written into a single buffer of the exact size. Strings with a different encoding
+ * are transcoded (or just copied when they can be rebased).
+ *
+ * Pieces are stored by value, but strings are only views: the referenced data must be alive until
+ * the expression is materialized
+ */
+template<general_enctype T, typename L, typename R>
+class concat_expr;
+
+template<general_enctype T, typename P>
+struct concat_piece;
+
+template<general_enctype T, general_enctype S>
+struct concat_piece<T, adv_string_view<S>>{
+    static dimensions measure(const adv_string_view<S> &, EncMetric_info<T>);
+    static byte *write(const adv_string_view<S> &, EncMetric_info<T>, byte *, size_t &);
+};
+
+template<general_enctype T>
+struct concat_piece<T, typename T::ctype>{
+    static dimensions measure(const typename T::ctype &, EncMetric_info<T>);
+    static byte *write(const typename T::ctype &, EncMetric_info<T>, byte *, size_t &);
+};
+
+template<general_enctype T, typename L, typename R>
+struct concat_piece<T, concat_expr<T, L, R>>{
+    static dimensions measure(const concat_expr<T, L, R> &e, EncMetric_info<T>){ return e.measure();}
+    static byte *write(const concat_expr<T, L, R> &e, EncMetric_info<T>, byte *b, size_t &rem){ return e.write(b, rem);}
+};
+
+template<general_enctype T, typename L, typename R>
+class concat_expr{
+    private:
+        EncMetric_info<T> format;
+        L left;
+        R right;
+    public:
+        concat_expr(EncMetric_info<T> f, const L &l, const R &r) : format{f}, left{l}, right{r} {}
+
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+        /*
+         * Length and size of the resulting string
+         */
+        dimensions measure() const{
+            dimensions a = concat_piece<T, L>::measure(left, format);
+            dimensions b = concat_piece<T, R>::measure(right, format);
+            a.len += b.len;
+            a.siz += b.siz;
+            return a;
+        }
+        /*
+         * Writes the string into b, that must contain at least measure().siz bytes
+         */
+        byte *write(byte *b, size_t &rem) const{
+            b = concat_piece<T, L>::write(left, format, b, rem);
+            return concat_piece<T, R>::write(right, format, b, rem);
+        }
+
+        adv_string<T> to_string(std::pmr::memory_resource *) const;
+        adv_string<T> to_string() const{ return to_string(std::pmr::get_default_resource());}
+        operator adv_string<T>() const{ return to_string();}
+};
+
+template<general_enctype T, general_enctype S> requires std::same_as<typename T::ctype, typename S::ctype>
+concat_expr<T, adv_string_view<T>, adv_string_view<S>> operator+(const adv_string_view<T> &a, const adv_string_view<S> &b){
+    return concat_expr<T, adv_string_view<T>, adv_string_view<S>>{a.raw_format(), a, b};
+}
+
+template<general_enctype T>
+concat_expr<T, adv_string_view<T>, typename T::ctype> operator+(const adv_string_view<T> &a, std::type_identity_t<typename T::ctype> c){
+    return concat_expr<T, adv_string_view<T>, typename T::ctype>{a.raw_format(), a, c};
+}
+
+template<general_enctype T>
+concat_expr<T, typename T::ctype, adv_string_view<T>> operator+(std::type_identity_t<typename T::ctype> c, const adv_string_view<T> &a){
+    return concat_expr<T, typename T::ctype, adv_string_view<T>>{a.raw_format(), c, a};
+}
+
+template<general_enctype T, typename L, typename R, general_enctype S> requires std::same_as<typename T::ctype, typename S::ctype>
+concat_expr<T, concat_expr<T, L, R>, adv_string_view<S>> operator+(const concat_expr<T, L, R> &e, const adv_string_view<S> &b){
+    return concat_expr<T, concat_expr<T, L, R>, adv_string_view<S>>{e.raw_format(), e, b};
+}
+
+template<general_enctype T, typename L, typename R>
+concat_expr<T, concat_expr<T, L, R>, typename T::ctype> operator+(const concat_expr<T, L, R> &e, std::type_identity_t<typename T::ctype> c){
+    return concat_expr<T, concat_expr<T, L, R>, typename T::ctype>{e.raw_format(), e, c};
+}
+
+template<general_enctype T, typename L, typename R, typename L2, typename R2>
+concat_expr<T, concat_expr<T, L, R>, concat_expr<T, L2, R2>> operator+(const concat_expr<T, L, R> &e, const concat_expr<T, L2, R2> &f){
+    return concat_expr<T, concat_expr<T, L, R>, concat_expr<T, L2, R2>>{e.raw_format(), e, f};
+}
+
+#include <strsuite/encmetric/concat.tpp>
+}
@@ -0,0 +1,95 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * Size of a single encoded character
+ */
+template<general_enctype T>
+uint encoded_size(const typename T::ctype &c, EncMetric_info<T> f){
+    byte tmp[16];
+    try{
+        return f.encode(c, tmp, 16);
+    }
+    catch(buffer_small &e){
+        basic_ptr big{16 + e.get_required_size()};
+        return f.encode(c, big.memory, big.dimension);
+    }
+}
+
+template<general_enctype T, general_enctype S>
+dimensions concat_piece<T, adv_string_view<S>>::measure(const adv_string_view<S> &str, EncMetric_info<T> f){
+    dimensions ret{};
+    ret.len = str.length();
+    if(str.can_rebase(f)){
+        ret.siz = str.size();
+        return ret;
+    }
+    const_tchar_pt<S> pt = str.begin();
+    size_t rem = str.size();
+    for(size_t i=0; i<ret.len; i++)
+        ret.siz += encoded_size(get_chr_el(pt.decode_next_update(rem)), f);
+    return ret;
+}
+
+template<general_enctype T, general_enctype S>
+byte *concat_piece<T, adv_string_view<S>>::write(const adv_string_view<S> &str, EncMetric_info<T> f, byte *b, size_t &brem){
+    if(str.can_rebase(f)){
+        copy_bytes(b, str.data(), str.size());
+        brem -= str.size();
+        return b + str.size();
+    }
+    const_tchar_pt<S> pt = str.begin();
+    size_t rem = str.size();
+    for(size_t i=0; i<str.length(); i++){
+        uint w = f.encode(get_chr_el(pt.decode_next_update(rem)), b, brem);
+        b += w;
+        brem -= w;
+    }
+    return b;
+}
+
+template<general_enctype T>
+dimensions concat_piece<T, typename T::ctype>::measure(const typename T::ctype &c, EncMetric_info<T> f){
+    dimensions ret{};
+    ret.len = 1;
+    ret.siz = encoded_size(c, f);
+    return ret;
+}
+
+template<general_enctype T>
+byte *concat_piece<T, typename T::ctype>::write(const typename T::ctype &c, EncMetric_info<T> f, byte *b, size_t &brem){
+    uint w = f.encode(c, b, brem);
+    brem -= w;
+    return b + w;
+}
+
+template<general_enctype T, typename L, typename R>
+adv_string<T> concat_expr<T, L, R>::to_string(std::pmr::memory_resource *alloc) const{
+    dimensions dim = measure();
+    if(dim.siz <= adv_string<T>::sso_capacity){
+        byte tmp[adv_string<T>::sso_capacity];
+        size_t rem = dim.siz;
+        write(tmp, rem);
+        return adv_string<T>{direct_build(const_tchar_pt<T>{tmp, format}, dim.len, dim.siz), alloc};
+    }
+    basic_ptr buf{dim.siz, alloc};
+    size_t rem = dim.siz;
+    write(buf.memory, rem);
+    return direct_build_dyn(std::move(buf), dim.len, dim.siz, format);
+}
@@ -17,31 +17,116 @@
     You should have received a copy of the GNU Lesser General Public License
     along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
 */
+#include <string>
+#include <vector>
 #include <strsuite/encmetric/enc_string.hpp>
 
 namespace sts{
 
+/*
+ * Number of bytes an adv_string<T> can store inside the object itself without allocating memory.
+ *
+ * By default it's the smallest multiple of T::min_bytes() not lesser than 24, you can specialize
+ * this class in order to change it for a specific encoding
+ */
+template<general_enctype T>
+struct sso_size : public std::integral_constant<size_t, 24>{};
+
+template<strong_enctype T>
+struct sso_size<T> : public std::integral_constant<size_t, ((24 + T::min_bytes() - 1) / T::min_bytes()) * T::min_bytes()>{};
+
+template<general_enctype T>
+class shared_string;
+
 template<general_enctype T>
 class adv_string : public adv_string_view<T>{
+	public:
+		static constexpr size_t sso_capacity = sso_size<T>::value;
 	private:
-		basic_ptr bind;
-
-		adv_string(const_tchar_pt<T>, size_t, size_t, basic_ptr);
+		struct heap_block{
+			byte *memory;
+			std::size_t dimension;
+		};
+		std::pmr::memory_resource *alloc;
+		/*
+		 * Short strings are stored in local, otherwise heap is active. The string is local if and only
+		 * if the view points to local, so no tag is needed
+		 */
+		union{
+			heap_block heap;
+			byte local[sso_capacity];
+		};
 
 		/*
 			USE WITH EXTREME CARE
 		*/
 		adv_string(EncMetric_info<T>, size_t len, size_t siz, basic_ptr data);
+
+		byte *storage() noexcept{ return is_local() ? local : heap.memory;}
+		/*
+		 * Moves the string in an allocated buffer of at least nbytes bytes
+		 */
+		void grow(size_t nbytes, bool geometric);
+		/*
+		 * Replaces rem bytes at position pos with add uninitialized bytes and returns a pointer to them,
+		 * bytes after the gap are preserved. Doesn't update the length
+		 */
+		byte *open_gap(size_t pos, size_t rem, size_t add);
+		void insert_bytes(size_t pos, size_t rem, size_t remlen, const adv_string_view<T> &);
 	public:
 		adv_string(const adv_string_view<T> &, std::pmr::memory_resource *alloc);
 		adv_string(const adv_string<T> &me) : adv_string{static_cast<const adv_string_view<T> &>(me), me.get_allocator()} {}
-		adv_string(adv_string &&st) noexcept =default;
+		adv_string(adv_string &&st) noexcept;
+		~adv_string();
+
+		std::pmr::memory_resource *get_allocator() const noexcept{return alloc;}
+		/*
+		 * True if the string is stored inside the object
+		 */
+		bool is_local() const noexcept{ return this->data() == local;}
+		std::size_t capacity() const noexcept{ return is_local() ? sso_capacity : heap.dimension;}
 
-		std::pmr::memory_resource *get_allocator() const noexcept{return bind.get_allocator();}
-		std::size_t capacity() const noexcept{ return bind.dimension;}
+		using placeholder = typename adv_string_view<T>::placeholder;
+		using ctype = typename T::ctype;
+		/*
+		 * In-place modifiers, lengths are updated without scanning the whole string again.
+		 *
+		 * Memory grows exponentially, so repeated appends take amortized constant time.
+		 * All placeholders obtained before the modification become invalid
+		 */
+		void reserve(size_t nbytes);
+		void clear() noexcept{ this->rebind(storage(), 0, 0);}
+		/*
+		 * Gives the string buffer to the caller without copying it (short strings are copied in a new
+		 * buffer), encoded data starts at the first byte and is size() bytes long.
+		 *
+		 * The string becomes empty
+		 */
+		basic_ptr release();
+
+		template<general_enctype S>
+		adv_string &append(const adv_string_view<S> &str){ insert_bytes(this->size(), 0, 0, str.rebase(this->raw_format())); return *this;}
+		adv_string &push_back(const ctype &);
+		template<general_enctype S>
+		adv_string &insert(placeholder p, const adv_string_view<S> &str){
+			this->validate(p);
+			insert_bytes(p.nbytes(), 0, 0, str.rebase(this->raw_format()));
+			return *this;
+		}
+		adv_string &erase(placeholder b, placeholder e);
+		template<general_enctype S>
+		adv_string &replace(placeholder b, placeholder e, const adv_string_view<S> &str){
+			this->validate(b);
+			this->validate(e);
+			if(e < b)
+				std::swap(b, e);
+			insert_bytes(b.nbytes(), e.nbytes() - b.nbytes(), e.nchr() - b.nchr(), str.rebase(this->raw_format()));
+			return *this;
+		}
 
 	//template<general_enctype S>
 	//friend class adv_string_view;
+    friend class shared_string<T>;
     friend adv_string<T> direct_build_dyn<T>(basic_ptr, size_t , size_t, EncMetric_info<T>);
 };
 
@@ -51,36 +136,85 @@ adv_string<T> direct_build_dyn(basic_ptr data, size_t len, size_t siz, EncMetric
 }
 
 
+/*
+ * Takes the first siz bytes of data without copying them, the string is verified only if check is true.
+ *
+ * Throws out_of_range if siz is greater than the buffer and incorrect_encoding if the last character is incomplete
+ */
+template<general_enctype T>
+adv_string<T> adopt_string(basic_ptr data, size_t siz, EncMetric_info<T> enc, bool check = true);
+
+template<strong_enctype T>
+adv_string<T> adopt_string(basic_ptr data, size_t siz, bool check = true){
+    return adopt_string<T>(std::move(data), siz, EncMetric_info<T>{}, check);
+}
+
+template<general_enctype T>
+adv_string<T> adopt_string(owned_bytes data, size_t siz, EncMetric_info<T> enc, bool check = true){
+    return adopt_string<T>(basic_ptr{std::move(data)}, siz, enc, check);
+}
+
+template<strong_enctype T>
+adv_string<T> adopt_string(owned_bytes data, size_t siz, bool check = true){
+    return adopt_string<T>(basic_ptr{std::move(data)}, siz, EncMetric_info<T>{}, check);
+}
+
+/*
+ * Standard containers whose data can be adopted
+ */
+template<typename C>
+concept adoptable_container = std::same_as<C, std::string> || std::same_as<C, std::u8string> || std::same_as<C, std::vector<std::byte>>;
+
+/*
+ * Takes the content of a moved std::string, std::u8string or std::vector<std::byte> without copying it,
+ * the container is kept alive by get_container_resource() and destroyed when the string releases
+ * its buffer
+ */
+template<general_enctype T, adoptable_container C>
+adv_string<T> adopt_string(C &&cont, EncMetric_info<T> enc, bool check = true){
+    size_t siz = cont.size();
+    if(siz == 0)
+        return direct_build_dyn(basic_ptr{}, 0, 0, enc);
+    container_resource *res = get_container_resource();
+    byte *mem = res->adopt(std::move(cont));
+    return adopt_string<T>(basic_ptr{owned_bytes{mem, pmr_deleter{res, siz}}}, siz, enc, check);
+}
+
+template<strong_enctype T, adoptable_container C>
+adv_string<T> adopt_string(C &&cont, bool check = true){
+    return adopt_string<T>(std::move(cont), EncMetric_info<T>{}, check);
+}
+
 //------------------------
 
-template<strong_enctype T, typename U, typename FuncType>
+template<strong_enctype T, typename U, typename FuncType> requires is_terminate_func<FuncType, T>
 adv_string<T> alloc_string(const U *b, size_t maxsiz, const FuncType &t, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b), maxsiz, t}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b}, maxsiz, t}, alloc};
 }
 
 template<strong_enctype T, typename U>
 adv_string<T> alloc_string(const U *b, size_t maxsiz, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b), maxsiz, zero_terminating<T>}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b}, maxsiz, zero_terminating<T>}, alloc};
 }
 
 template<strong_enctype T, typename U>
 adv_string<T> alloc_string(const U *b, size_t siz, size_t len, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b), siz, len}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b}, siz, len}, alloc};
 }
 
-template<widenc T, typename U, typename FuncType>
+template<widenc T, typename U, typename FuncType> requires is_terminate_func<FuncType, T>
 adv_string<T> alloc_string(const U *b, const EncMetric<typename T::ctype> *f, size_t maxsiz, const FuncType &t, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b, f), maxsiz, t}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b, f}, maxsiz, t}, alloc};
 }
 
 template<widenc T, typename U>
 adv_string<T> alloc_string(const U *b, const EncMetric<typename T::ctype> *f, size_t maxsiz, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b, f), maxsiz, zero_terminating<T>}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b, f}, maxsiz, zero_terminating<T>}, alloc};
 }
 
 template<widenc T, typename U>
 adv_string<T> alloc_string(const U *b, const EncMetric<typename T::ctype> *f, size_t siz, size_t len, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()){
-        return adv_string<T>{adv_string_view<T>{new_const_pt<T>(b, f), siz, len}, alloc};
+        return adv_string<T>{adv_string_view<T>{const_tchar_pt<T>{b, f}, siz, len}, alloc};
 }
 
 using wstr = adv_string<WIDEchr>;
@@ -17,15 +17,176 @@
 */
 
 template<typename T>
-adv_string<T>::adv_string(const_tchar_pt<T> ptr, size_t len, size_t siz, basic_ptr by) : adv_string_view<T>{len, siz, ptr}, bind{std::move(by)} {}
+adv_string<T>::adv_string(EncMetric_info<T> enc, size_t len, size_t siz, basic_ptr by) : adv_string_view<T>{len, siz, const_tchar_pt<T>{local, enc}}, alloc{by.get_allocator()} {
+    if(by.memory != nullptr){
+        heap.dimension = by.dimension;
+        heap.memory = by.leave();
+        this->rebind(heap.memory, len, siz);
+    }
+}
 
 template<typename T>
-adv_string<T>::adv_string(EncMetric_info<T> enc, size_t len, size_t siz, basic_ptr by) : adv_string_view<T>{len, siz, const_tchar_pt<T>{by.memory, enc}}, bind{std::move(by)} {}
+adv_string<T>::adv_string(const adv_string_view<T> &st, std::pmr::memory_resource *alloc)
+	 : adv_string{st.raw_format(), st.length(), st.size(), st.size() <= sso_capacity ? basic_ptr{alloc} : basic_ptr{st.data(), (std::size_t)st.size(), alloc}} {
+    if(is_local() && st.size() > 0)
+        copy_bytes(local, st.data(), st.size());
+}
 
+template<typename T>
+adv_string<T>::adv_string(adv_string &&st) noexcept : adv_string_view<T>{st}, alloc{st.alloc} {
+    if(st.is_local()){
+        if(this->size() > 0)
+            copy_bytes(local, st.local, this->size());
+        this->rebind(local, this->length(), this->size());
+    }
+    else
+        heap = st.heap;
+    st.rebind(st.local, 0, 0);
+}
 
 template<typename T>
-adv_string<T>::adv_string(const adv_string_view<T> &st, std::pmr::memory_resource *alloc)
-	 : adv_string{st.raw_format(), st.length(), st.size(), basic_ptr{st.data(), (std::size_t)st.size(), alloc}} {}
+adv_string<T>::~adv_string(){
+    if(!is_local())
+        alloc->deallocate(heap.memory, heap.dimension);
+}
+
+template<typename T>
+void adv_string<T>::grow(size_t nbytes, bool geometric){
+    bool was_local = is_local();
+    basic_ptr tmp{alloc};
+    if(!was_local)
+        tmp = basic_ptr{owned_bytes{heap.memory, pmr_deleter{alloc, heap.dimension}}};
+    try{
+        if(geometric)
+            tmp.exp_fit(nbytes);
+        else
+            tmp.reallocate(nbytes);
+    }
+    catch(...){
+        /*
+         * The old buffer is still owned by this string
+         */
+        if(!was_local)
+            tmp.leave();
+        throw;
+    }
+    if(was_local && this->size() > 0)
+        copy_bytes(tmp.memory, local, this->size());
+    heap.dimension = tmp.dimension;
+    heap.memory = tmp.leave();
+    this->rebind(heap.memory, this->length(), this->size());
+}
+
+template<typename T>
+byte *adv_string<T>::open_gap(size_t pos, size_t rem, size_t add){
+    size_t tail = this->size() - pos - rem;
+    size_t nsiz = pos + add + tail;
+    if(nsiz < pos + tail)
+        throw std::length_error{"adv_string too large"};
+    if(nsiz > capacity())
+        grow(nsiz, true);
+    byte *base = storage();
+    if(rem != add && tail > 0)
+        move_bytes(base + pos + add, base + pos + rem, tail);
+    return base + pos;
+}
 
+template<typename T>
+void adv_string<T>::insert_bytes(size_t pos, size_t rem, size_t remlen, const adv_string_view<T> &str){
+    const byte *base = storage();
+    if(str.size() > 0 && str.data() >= base && str.data() < base + capacity()){
+        /*
+         * str lives inside this string
+         */
+        adv_string<T> cp{str, get_allocator()};
+        insert_bytes(pos, rem, remlen, cp);
+        return;
+    }
+    size_t nlen = this->length() - remlen + str.length();
+    size_t nsiz = this->size() - rem + str.size();
+    byte *gap = open_gap(pos, rem, str.size());
+    copy_bytes(gap, str.data(), str.size());
+    this->rebind(storage(), nlen, nsiz);
+}
 
+template<typename T>
+void adv_string<T>::reserve(size_t nbytes){
+    if(nbytes <= capacity())
+        return;
+    grow(nbytes, false);
+}
+
+template<typename T>
+adv_string<T> &adv_string<T>::push_back(const ctype &c){
+    EncMetric_info<T> f = this->raw_format();
+    size_t pos = this->size();
+    if(f.has_max()){
+        byte *gap = open_gap(pos, 0, f.max_bytes());
+        uint w = f.encode(c, gap, f.max_bytes());
+        this->rebind(storage(), this->length() + 1, pos + w);
+        return *this;
+    }
+    byte tmp[16];
+    basic_ptr big{get_allocator()};
+    byte *src = tmp;
+    uint w;
+    try{
+        w = f.encode(c, tmp, 16);
+    }
+    catch(buffer_small &e){
+        big.reallocate(16 + e.get_required_size());
+        w = f.encode(c, big.memory, big.dimension);
+        src = big.memory;
+    }
+    byte *gap = open_gap(pos, 0, w);
+    copy_bytes(gap, src, w);
+    this->rebind(storage(), this->length() + 1, pos + w);
+    return *this;
+}
+
+template<typename T>
+adv_string<T> &adv_string<T>::erase(placeholder b, placeholder e){
+    this->validate(b);
+    this->validate(e);
+    if(e < b)
+        std::swap(b, e);
+    size_t nlen = this->length() - (e.nchr() - b.nchr());
+    size_t nsiz = this->size() - (e.nbytes() - b.nbytes());
+    open_gap(b.nbytes(), e.nbytes() - b.nbytes(), 0);
+    this->rebind(storage(), nlen, nsiz);
+    return *this;
+}
+
+template<typename T>
+basic_ptr adv_string<T>::release(){
+    basic_ptr ret{alloc};
+    if(is_local()){
+        if(this->size() > 0)
+            ret = basic_ptr{local, this->size(), alloc};
+    }
+    else
+        ret = basic_ptr{owned_bytes{heap.memory, pmr_deleter{alloc, heap.dimension}}};
+    this->rebind(local, 0, 0);
+    return ret;
+}
 
+template<general_enctype T>
+adv_string<T> adopt_string(basic_ptr data, size_t siz, EncMetric_info<T> enc, bool check){
+    if(siz > data.dimension)
+        throw out_of_range{"Adopted string exceeds its buffer"};
+    size_t len;
+    if(enc.is_fixed()){
+        if(siz % enc.min_bytes() != 0)
+            throw incorrect_encoding{"Incomplete last character"};
+        len = siz / enc.min_bytes();
+    }
+    else{
+        dimensions dim = deduce_lens(const_tchar_pt<T>{data.memory, enc}, siz);
+        if(dim.siz != siz)
+            throw incorrect_encoding{"Incomplete last character"};
+        len = dim.len;
+    }
+    if(check && siz > 0)
+        direct_build(const_tchar_pt<T>{data.memory, enc}, len, siz).verify();
+    return direct_build_dyn(std::move(data), len, siz, enc);
+}
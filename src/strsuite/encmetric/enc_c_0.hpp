@@ -17,6 +17,10 @@
     along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
 */
 #include <strsuite/encmetric/dynstring.hpp>
+#include <strsuite/encmetric/string_arena.hpp>
+#include <strsuite/encmetric/shared_string.hpp>
+#include <strsuite/encmetric/concat.hpp>
+#include <strsuite/encmetric/compact_view.hpp>
 #include <strsuite/encmetric/all_enc.hpp>
 #include <strsuite/encmetric/config.hpp>
 #include <type_traits>
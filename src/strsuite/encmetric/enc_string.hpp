@@ -66,6 +66,10 @@ bool encoding_terminating(const byte *data, const EncMetric_info<T> &format, siz
     return cha == ctype{0};
 }
 
+/*
+ * Views are trivially copyable and have no virtual members, so classes that extend them
+ * (like adv_string) must never be destroyed through a pointer to adv_string_view
+ */
 template<general_enctype T>
 class adv_string_view{
 	private:
@@ -74,6 +78,14 @@ class adv_string_view{
 		size_t siz;//bytes number
 	protected:
 		explicit adv_string_view(size_t length, size_t size, const_tchar_pt<T> bin) noexcept : ptr{bin}, len{length}, siz{size} {}
+		/*
+		 * Points the view to a new memory block, used by mutable derived classes
+		 */
+		void rebind(const byte *b, size_t length, size_t size) noexcept{
+			ptr = const_tchar_pt<T>{b, ptr.raw_format()};
+			len = length;
+			siz = size;
+		}
 	public:
 
         using ctype = typename T::ctype;
@@ -84,7 +96,7 @@ class adv_string_view{
             size_t siz, len;
             placeholder(const byte *p, size_t s, size_t l) : start{p}, siz{s}, len{l} {}
         public:
-            ~placeholder() {}
+            ~placeholder() = default;
 
             const byte *data() const noexcept;
             size_t nbytes() const noexcept;
@@ -136,7 +148,6 @@ class adv_string_view{
 		template<typename U>
 		explicit adv_string_view(const U *b, const EncMetric<typename T::ctype> *f, size_t siz, size_t len) requires widenc<T> : adv_string_view{const_tchar_pt<T>{b, f}, siz, len} {}
 
-		virtual ~adv_string_view() {}
 		/*
 		    Verify the string is correctly encoded
 		*/
@@ -21,6 +21,18 @@ dimensions deduce_lens(const_tchar_pt<T> ptr, size_t maxsiz){
 	uint add=0;
 
 	while(maxsiz > 0){
+        if constexpr(is_base_for<ASCII, T>){
+            /*
+             * ASCII characters are counted in blocks
+             */
+            size_t asc = ascii_prefix(ptr.data(), maxsiz);
+            ptr += static_cast<std::ptrdiff_t>(asc);
+            maxsiz -= asc;
+            ret.siz += asc;
+            ret.len += asc;
+            if(maxsiz == 0)
+                break;
+        }
         try{
             add = ptr.next_update(maxsiz);
             ret.siz += add;
@@ -255,6 +267,16 @@ adv_string_view<T> adv_string_view<T>::substring(placeholder b, placeholder e) c
     return adv_string_view<T>{e.len - b.len, e.siz - b.siz, at(b)};
 }
 
+template<typename T>
+adv_string_view<T> adv_string_view<T>::substring(placeholder b) const{
+    return substring(b, select_end());
+}
+
+template<typename T>
+adv_string_view<T> adv_string_view<T>::substring(size_t b) const{
+    return substring(select(b), select_end());
+}
+
 template<typename T>
 template<general_enctype S>
 bool adv_string_view<T>::equal_to(const adv_string_view<S> &t, size_t ch) const{
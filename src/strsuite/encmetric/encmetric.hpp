@@ -136,7 +136,7 @@ template<general_enctype T>
 class EncMetric_info{
 	public:
 		using ctype=typename T::ctype;
-		constexpr EncMetric_info(const EncMetric_info<T> &) noexcept {}
+		constexpr EncMetric_info(const EncMetric_info<T> &) noexcept = default;
 		constexpr EncMetric_info() noexcept {}
 		const EncMetric<ctype> *format() const noexcept {return DynEncoding<T>::instance();}
 
@@ -215,7 +215,7 @@ class EncMetric_info<WIDE<tt>>{
 	public:
 		using ctype=tt;
 		constexpr EncMetric_info(const EncMetric<tt> *format) noexcept : f{format} {}
-		constexpr EncMetric_info(const EncMetric_info &info) noexcept : f{info.f} {}
+		constexpr EncMetric_info(const EncMetric_info &) noexcept = default;
 		constexpr const EncMetric<tt> *format() const noexcept {return f;}
 
 		uint min_bytes() const noexcept {return f->d_min_bytes();}
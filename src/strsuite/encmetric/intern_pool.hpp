@@ -0,0 +1,154 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <strsuite/encmetric/enc_string.hpp>
+#include <strsuite/encmetric/string_arena.hpp>
+
+namespace sts{
+
+struct intern_stats{
+    size_t lookups;
+    size_t hits;
+    /*
+     * Number of different strings and their total size in bytes
+     */
+    size_t unique;
+    size_t bytes_stored;
+    /*
+     * Bytes that would have been allocated without the pool
+     */
+    size_t bytes_saved;
+    /*
+     * Memory requested to the upstream resource
+     */
+    size_t bytes_reserved;
+
+    double hit_rate() const noexcept{ return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);}
+};
+
+/*
+ * Thread-safe string interning table.
+ *
+ * Every string is stored exactly once and never moves until the pool is destroyed, so two interned
+ * strings of the same pool are equal if and only if their data pointers are the same.
+ *
+ * The table is divided into shards, each protected by its own reader/writer lock: lookups of already
+ * interned strings only take a shared lock
+ */
+template<general_enctype T>
+class intern_pool{
+    private:
+        struct record{
+            size_t len;
+            size_t siz;
+            const byte *data() const noexcept{ return reinterpret_cast<const byte *>(this + 1);}
+        };
+        struct shard{
+            mutable std::shared_mutex mtx;
+            std::unordered_map<std::string_view, const record *> table;
+            string_arena storage;
+            shard(std::pmr::memory_resource *up) : mtx{}, table{}, storage{4096, up} {}
+        };
+
+        std::vector<std::unique_ptr<shard>> shards;
+        size_t mask;
+        EncMetric_info<T> format;
+        std::atomic<size_t> nlookups, nhits, nunique, nstored, nsaved;
+
+        static std::string_view key_of(const byte *b, size_t siz) noexcept{
+            return std::string_view{reinterpret_cast<const char *>(b), siz};
+        }
+        shard &select_shard(size_t hash) const noexcept{
+            /*
+             * std::unordered_map uses the low bits of the hash
+             */
+            return *shards[(hash >> 16) & mask];
+        }
+        adv_string_view<T> build_view(const record *r) const noexcept{
+            return direct_build(const_tchar_pt<T>{r->data(), format}, r->len, r->siz);
+        }
+        const record *find_record(const adv_string_view<T> &) const;
+        const record *intern_record(const adv_string_view<T> &);
+    public:
+        /*
+         * Compact reference to an interned string, two handles of the same pool are equal
+         * if and only if they refer to the same string
+         */
+        class handle{
+            private:
+                const record *rec;
+                explicit handle(const record *r) noexcept : rec{r} {}
+            public:
+                handle() noexcept : rec{nullptr} {}
+                bool empty() const noexcept{ return rec == nullptr;}
+                size_t length() const noexcept{ return rec == nullptr ? 0 : rec->len;}
+                size_t size() const noexcept{ return rec == nullptr ? 0 : rec->siz;}
+                const byte *data() const noexcept{ return rec == nullptr ? nullptr : rec->data();}
+                adv_string_view<T> view() const noexcept requires strong_enctype<T>{
+                    return direct_build(const_tchar_pt<T>{data(), EncMetric_info<T>{}}, length(), size());
+                }
+                bool operator==(const handle &h) const noexcept{ return rec == h.rec;}
+                friend class intern_pool<T>;
+        };
+
+        explicit intern_pool(EncMetric_info<T>, size_t nshards = 16, std::pmr::memory_resource *up = std::pmr::get_default_resource());
+        explicit intern_pool(size_t nshards = 16, std::pmr::memory_resource *up = std::pmr::get_default_resource()) requires strong_enctype<T> : intern_pool{EncMetric_info<T>{}, nshards, up} {}
+        explicit intern_pool(const EncMetric<typename T::ctype> *f, size_t nshards = 16, std::pmr::memory_resource *up = std::pmr::get_default_resource()) requires widenc<T> : intern_pool{EncMetric_info<T>{f}, nshards, up} {}
+        intern_pool(const intern_pool &) = delete;
+        intern_pool &operator=(const intern_pool &) = delete;
+
+        /*
+         * Returns the stored copy of the string, that is inserted if not present
+         */
+        template<general_enctype S>
+        adv_string_view<T> intern(const adv_string_view<S> &str){
+            return build_view(intern_record(str.rebase(format)));
+        }
+        template<general_enctype S>
+        handle intern_handle(const adv_string_view<S> &str){
+            return handle{intern_record(str.rebase(format))};
+        }
+        /*
+         * Doesn't insert anything
+         */
+        template<general_enctype S>
+        conditional_result<adv_string_view<T>> find(const adv_string_view<S> &str) const{
+            const record *r = find_record(str.rebase(format));
+            if(r == nullptr)
+                return conditional_result<adv_string_view<T>>{false, adv_string_view<T>{format}};
+            return conditional_result<adv_string_view<T>>{true, build_view(r)};
+        }
+        adv_string_view<T> get(handle h) const noexcept{
+            if(h.empty())
+                return adv_string_view<T>{format};
+            return build_view(h.rec);
+        }
+
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+        intern_stats stats() const;
+};
+
+#include <strsuite/encmetric/intern_pool.tpp>
+}
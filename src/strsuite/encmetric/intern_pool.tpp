@@ -0,0 +1,94 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T>
+intern_pool<T>::intern_pool(EncMetric_info<T> f, size_t nshards, std::pmr::memory_resource *up) : shards{}, mask{0}, format{f}, nlookups{0}, nhits{0}, nunique{0}, nstored{0}, nsaved{0} {
+    size_t n = 1;
+    while(n < nshards)
+        n *= 2;
+    mask = n - 1;
+    shards.reserve(n);
+    for(size_t i=0; i<n; i++)
+        shards.push_back(std::make_unique<shard>(up));
+}
+
+template<general_enctype T>
+auto intern_pool<T>::find_record(const adv_string_view<T> &str) const -> const record *{
+    std::string_view key = key_of(str.data(), str.size());
+    shard &sh = select_shard(std::hash<std::string_view>{}(key));
+    std::shared_lock lock{sh.mtx};
+    auto it = sh.table.find(key);
+    return it == sh.table.end() ? nullptr : it->second;
+}
+
+template<general_enctype T>
+auto intern_pool<T>::intern_record(const adv_string_view<T> &str) -> const record *{
+    std::string_view key = key_of(str.data(), str.size());
+    size_t hash = std::hash<std::string_view>{}(key);
+    shard &sh = select_shard(hash);
+    nlookups.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::shared_lock lock{sh.mtx};
+        auto it = sh.table.find(key);
+        if(it != sh.table.end()){
+            nhits.fetch_add(1, std::memory_order_relaxed);
+            nsaved.fetch_add(str.size(), std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+    std::unique_lock lock{sh.mtx};
+    /*
+     * Another thread may have inserted it in the meantime
+     */
+    auto it = sh.table.find(key);
+    if(it != sh.table.end()){
+        nhits.fetch_add(1, std::memory_order_relaxed);
+        nsaved.fetch_add(str.size(), std::memory_order_relaxed);
+        return it->second;
+    }
+    void *mem = sh.storage.allocate(sizeof(record) + str.size(), alignof(record));
+    record *rec = ::new(mem) record{str.length(), str.size()};
+    if(str.size() > 0)
+        copy_bytes(const_cast<byte *>(rec->data()), str.data(), str.size());
+    try{
+        sh.table.emplace(key_of(rec->data(), rec->siz), rec);
+    }
+    catch(...){
+        sh.storage.deallocate(mem, sizeof(record) + str.size(), alignof(record));
+        throw;
+    }
+    nunique.fetch_add(1, std::memory_order_relaxed);
+    nstored.fetch_add(str.size(), std::memory_order_relaxed);
+    return rec;
+}
+
+template<general_enctype T>
+intern_stats intern_pool<T>::stats() const{
+    intern_stats ret{};
+    ret.lookups = nlookups.load(std::memory_order_relaxed);
+    ret.hits = nhits.load(std::memory_order_relaxed);
+    ret.unique = nunique.load(std::memory_order_relaxed);
+    ret.bytes_stored = nstored.load(std::memory_order_relaxed);
+    ret.bytes_saved = nsaved.load(std::memory_order_relaxed);
+    ret.bytes_reserved = 0;
+    for(const auto &sh : shards){
+        std::shared_lock lock{sh->mtx};
+        ret.bytes_reserved += sh->storage.bytes_reserved();
+    }
+    return ret;
+}
@@ -0,0 +1,184 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <strsuite/encmetric/byte_tools.hpp>
+
+namespace sts{
+
+/*
+ * A memory resource that is also able to resize already allocated blocks.
+ *
+ * basic_ptr detects these resources and uses them in order to grow its memory
+ * without allocating a new block and copying the old data into it
+ */
+class expandable_resource : public std::pmr::memory_resource{
+    protected:
+        /*
+         * Tries to change the size of block p from old to nsiz bytes without moving it.
+         * If it returns false then the block is left unchanged
+         */
+        virtual bool do_try_expand(void *p, std::size_t old, std::size_t nsiz, std::size_t align) noexcept =0;
+        /*
+         * Same as C realloc: returns a block of nsiz bytes containing the first min(old, nsiz)
+         * bytes of p, that may be moved. If it throws p is left unchanged.
+         *
+         * The default implementation calls do_try_expand and then allocates a new block
+         */
+        virtual void *do_reallocate(void *p, std::size_t old, std::size_t nsiz, std::size_t align);
+    public:
+        bool try_expand(void *p, std::size_t old, std::size_t nsiz, std::size_t align = alignof(std::max_align_t)) noexcept{
+            return do_try_expand(p, old, nsiz, align);
+        }
+        void *reallocate(void *p, std::size_t old, std::size_t nsiz, std::size_t align = alignof(std::max_align_t)){
+            return do_reallocate(p, old, nsiz, align);
+        }
+};
+
+/*
+ * Uses malloc/realloc/free
+ */
+class malloc_resource final : public expandable_resource{
+    protected:
+        void *do_allocate(std::size_t, std::size_t) override;
+        void do_deallocate(void *, std::size_t, std::size_t) override;
+        bool do_is_equal(const std::pmr::memory_resource &) const noexcept override;
+        bool do_try_expand(void *, std::size_t, std::size_t, std::size_t) noexcept override;
+        void *do_reallocate(void *, std::size_t, std::size_t, std::size_t) override;
+};
+
+malloc_resource *get_malloc_resource() noexcept;
+
+/*
+ * Keeps alive standard containers whose data is owned by a basic_ptr.
+ *
+ * Deallocating the data of an adopted container destroys the container, all the other blocks are
+ * allocated and deallocated by upstream. Use get_container_resource() instead of building new
+ * instances, since the resource must outlive every block it gave
+ */
+class container_resource final : public std::pmr::memory_resource{
+    private:
+        struct holder_base{
+            virtual ~holder_base() {}
+        };
+        template<typename C>
+        struct holder : public holder_base{
+            C cont;
+            explicit holder(C &&c) : cont{std::move(c)} {}
+        };
+        std::pmr::memory_resource *upstream;
+        std::mutex mtx;
+        std::unordered_map<const void *, std::unique_ptr<holder_base>> owned;
+
+        void add(const void *, std::unique_ptr<holder_base>);
+    protected:
+        void *do_allocate(std::size_t, std::size_t) override;
+        void do_deallocate(void *, std::size_t, std::size_t) override;
+        bool do_is_equal(const std::pmr::memory_resource &) const noexcept override;
+    public:
+        explicit container_resource(std::pmr::memory_resource *up = std::pmr::new_delete_resource()) : upstream{up}, mtx{}, owned{} {}
+        container_resource(const container_resource &) = delete;
+        container_resource &operator=(const container_resource &) = delete;
+
+        /*
+         * Moves a non empty container inside the resource and returns its data, that must be
+         * deallocated with this resource
+         */
+        template<typename C>
+        byte *adopt(C &&c){
+            std::unique_ptr<holder<C>> h = std::make_unique<holder<C>>(std::move(c));
+            byte *ret = reinterpret_cast<byte *>(h->cont.data());
+            add(ret, std::move(h));
+            return ret;
+        }
+};
+
+container_resource *get_container_resource() noexcept;
+
+/*
+ * Monotonic allocator: memory is taken from chunks requested to upstream and it's released only
+ * when the resource is destroyed or release() is called.
+ *
+ * The last allocated block can always be expanded in place as long as the current chunk has
+ * enough free space, also deallocating it makes its memory available again.
+ */
+class monotonic_expand_resource : public expandable_resource{
+    private:
+        struct chunk_header{
+            chunk_header *prev;
+            std::size_t dim;
+        };
+        std::pmr::memory_resource *upstream;
+        chunk_header *chunks;
+        byte *cur, *lim, *last;
+        std::size_t next_dim;
+        std::size_t used, reserved;
+
+        void new_chunk(std::size_t min_dim);
+    protected:
+        void *do_allocate(std::size_t, std::size_t) override;
+        void do_deallocate(void *, std::size_t, std::size_t) override;
+        bool do_is_equal(const std::pmr::memory_resource &) const noexcept override;
+        bool do_try_expand(void *, std::size_t, std::size_t, std::size_t) noexcept override;
+
+        /*
+         * Free space in current chunk
+         */
+        std::size_t chunk_remaining() const noexcept{ return static_cast<std::size_t>(lim - cur);}
+        /*
+         * Allocates siz bytes without any alignment requirement
+         */
+        byte *bump_bytes(std::size_t siz){
+            if(chunk_remaining() < siz)
+                new_chunk(siz);
+            last = cur;
+            cur += siz;
+            used += siz;
+            return last;
+        }
+    public:
+        explicit monotonic_expand_resource(std::size_t initial_dim = 1024, std::pmr::memory_resource *up = std::pmr::get_default_resource());
+        monotonic_expand_resource(const monotonic_expand_resource &) = delete;
+        monotonic_expand_resource &operator=(const monotonic_expand_resource &) = delete;
+        ~monotonic_expand_resource();
+
+        /*
+         * Deallocates all the chunks
+         */
+        void release() noexcept;
+        std::pmr::memory_resource *upstream_resource() const noexcept{ return upstream;}
+
+        /*
+         * Bytes currently given to users
+         */
+        std::size_t bytes_used() const noexcept{ return used;}
+        /*
+         * Bytes requested to upstream
+         */
+        std::size_t bytes_reserved() const noexcept{ return reserved;}
+        /*
+         * Bytes lost due to alignment, deallocations and unused chunk tails
+         */
+        std::size_t bytes_wasted() const noexcept{ return reserved - used - chunk_remaining();}
+};
+
+}
@@ -0,0 +1,201 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <strsuite/encmetric/shared_string.hpp>
+
+namespace sts{
+
+/*
+ * Encoded string optimized for edits in the middle of big texts.
+ *
+ * The string is divided into immutable chunks (leaves) stored inside a balanced tree (a treap)
+ * whose nodes cache the total number of characters and bytes of their subtrees, so concatenations,
+ * insertions, deletions and character selections require O(log n) operations.
+ *
+ * Splitting a chunk doesn't copy it since leaves are shared_string objects. Inserted strings are
+ * cut into leaves of at most max_leaf bytes, so a split also needs to walk at most max_leaf bytes
+ */
+template<general_enctype T>
+class rope{
+    private:
+        struct node{
+            node *left, *right;
+            std::uint32_t prio;
+            size_t tlen, tsiz;
+            shared_string<T> piece;
+            node(shared_string<T> &&p, std::uint32_t pr) noexcept : left{nullptr}, right{nullptr}, prio{pr}, tlen{p.length()}, tsiz{p.size()}, piece{std::move(p)} {}
+        };
+        node *root;
+        EncMetric_info<T> format;
+        std::pmr::memory_resource *alloc;
+        std::uint32_t seed;
+
+        static size_t len_of(const node *n) noexcept{ return n == nullptr ? 0 : n->tlen;}
+        static size_t siz_of(const node *n) noexcept{ return n == nullptr ? 0 : n->tsiz;}
+        static void update(node *n) noexcept{
+            n->tlen = len_of(n->left) + n->piece.length() + len_of(n->right);
+            n->tsiz = siz_of(n->left) + n->piece.size() + siz_of(n->right);
+        }
+        std::uint32_t next_prio() noexcept{
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        }
+
+        node *new_node(shared_string<T> &&, std::uint32_t);
+        void delete_node(node *) noexcept;
+        void destroy(node *) noexcept;
+        node *clone(const node *);
+        static node *merge(node *, node *) noexcept;
+        /*
+         * The first tree contains the first chr characters
+         */
+        std::pair<node *, node *> split(node *, size_t chr);
+        /*
+         * Appends a short string to the last leaf of the tree by copying both
+         */
+        bool append_small(node *, const adv_string_view<T> &);
+        /*
+         * Copies the string once and builds a tree whose leaves share the copy
+         */
+        node *build_leaves(const adv_string_view<T> &);
+        void insert_view(size_t chr, const adv_string_view<T> &);
+    public:
+        /*
+         * Strings shorter than this are merged with the preceding leaf instead of building a new one
+         */
+        static constexpr size_t small_leaf = 64;
+        /*
+         * Maximum size of a leaf built from an inserted string, unless a single character is bigger
+         */
+        static constexpr size_t max_leaf = 1024;
+
+        struct position{
+            /*
+             * Characters and bytes before the selected character
+             */
+            size_t nchr, nbytes;
+            /*
+             * Leaf containing the character and its index inside the leaf
+             */
+            adv_string_view<T> leaf;
+            size_t leaf_nchr;
+        };
+
+        /*
+         * Iterates the leaves in order
+         */
+        class leaf_iterator{
+            private:
+                std::vector<const node *> stack;
+                void push_left(const node *n){
+                    while(n != nullptr){
+                        stack.push_back(n);
+                        n = n->left;
+                    }
+                }
+                explicit leaf_iterator(const node *n) : stack{} { push_left(n);}
+            public:
+                leaf_iterator() noexcept : stack{} {}
+                adv_string_view<T> operator*() const noexcept{ return stack.back()->piece.view();}
+                leaf_iterator &operator++(){
+                    const node *n = stack.back();
+                    stack.pop_back();
+                    push_left(n->right);
+                    return *this;
+                }
+                bool operator==(const leaf_iterator &it) const noexcept{
+                    if(stack.empty() || it.stack.empty())
+                        return stack.empty() && it.stack.empty();
+                    return stack.back() == it.stack.back();
+                }
+                friend class rope<T>;
+        };
+
+        explicit rope(EncMetric_info<T> f, std::pmr::memory_resource *all = std::pmr::get_default_resource()) noexcept : root{nullptr}, format{f}, alloc{all}, seed{0x9e3779b9u} {}
+        explicit rope(std::pmr::memory_resource *all = std::pmr::get_default_resource()) noexcept requires strong_enctype<T> : rope{EncMetric_info<T>{}, all} {}
+        explicit rope(const EncMetric<typename T::ctype> *f, std::pmr::memory_resource *all = std::pmr::get_default_resource()) noexcept requires widenc<T> : rope{EncMetric_info<T>{f}, all} {}
+        explicit rope(const adv_string_view<T> &str, std::pmr::memory_resource *all = std::pmr::get_default_resource()) : rope{str.raw_format(), all} {
+            append(str);
+        }
+        rope(const rope &);
+        rope(rope &&r) noexcept : root{r.root}, format{r.format}, alloc{r.alloc}, seed{r.seed} {
+            r.root = nullptr;
+        }
+        ~rope(){ clear();}
+        rope &operator=(const rope &);
+        rope &operator=(rope &&) noexcept;
+
+        size_t length() const noexcept{ return len_of(root);}
+        size_t size() const noexcept{ return siz_of(root);}
+        bool empty() const noexcept{ return root == nullptr;}
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+        std::pmr::memory_resource *get_allocator() const noexcept{ return alloc;}
+
+        /*
+         * Inserted strings are copied once
+         */
+        template<general_enctype S>
+        void insert(size_t chr, const adv_string_view<S> &str){ insert_view(chr, str.rebase(format));}
+        template<general_enctype S>
+        void append(const adv_string_view<S> &str){ insert_view(length(), str.rebase(format));}
+        template<general_enctype S>
+        void prepend(const adv_string_view<S> &str){ insert_view(0, str.rebase(format));}
+        /*
+         * Moves all the leaves of r without copying them
+         */
+        void insert(size_t chr, rope &&r);
+        void append(rope &&r){ insert(length(), std::move(r));}
+        /*
+         * Removes characters in [b, e)
+         */
+        void erase(size_t b, size_t e);
+        /*
+         * Removes all the characters from chr and returns them
+         */
+        rope split_at(size_t chr);
+        void clear() noexcept;
+
+        position select(size_t chr) const;
+        typename T::ctype get_char(size_t chr) const;
+
+        leaf_iterator begin() const{ return leaf_iterator{root};}
+        leaf_iterator end() const noexcept{ return leaf_iterator{};}
+        /*
+         * Writes all the leaves to a character stream without copying them
+         */
+        template<typename Stream>
+        size_t write_to(Stream &stream) const requires requires(Stream s, const adv_string_view<T> &v){ s.string_write(v);}{
+            size_t ret = 0;
+            for(adv_string_view<T> leaf : *this)
+                ret += stream.string_write(leaf);
+            return ret;
+        }
+        /*
+         * Builds a contiguous string
+         */
+        adv_string<T> to_string(std::pmr::memory_resource *) const;
+        adv_string<T> to_string() const{ return to_string(alloc);}
+};
+
+#include <strsuite/encmetric/rope.tpp>
+}
@@ -0,0 +1,320 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+template<general_enctype T>
+auto rope<T>::new_node(shared_string<T> &&p, std::uint32_t pr) -> node *{
+    std::pmr::polymorphic_allocator<node> all{alloc};
+    node *ret = all.allocate(1);
+    ::new(ret) node{std::move(p), pr};
+    return ret;
+}
+
+template<general_enctype T>
+void rope<T>::delete_node(node *n) noexcept{
+    std::pmr::polymorphic_allocator<node> all{alloc};
+    n->~node();
+    all.deallocate(n, 1);
+}
+
+template<general_enctype T>
+void rope<T>::destroy(node *n) noexcept{
+    if(n == nullptr)
+        return;
+    destroy(n->left);
+    destroy(n->right);
+    delete_node(n);
+}
+
+template<general_enctype T>
+auto rope<T>::clone(const node *n) -> node *{
+    if(n == nullptr)
+        return nullptr;
+    node *ret = new_node(shared_string<T>{n->piece}, n->prio);
+    try{
+        ret->left = clone(n->left);
+        ret->right = clone(n->right);
+    }
+    catch(...){
+        destroy(ret);
+        throw;
+    }
+    ret->tlen = n->tlen;
+    ret->tsiz = n->tsiz;
+    return ret;
+}
+
+template<general_enctype T>
+auto rope<T>::merge(node *a, node *b) noexcept -> node *{
+    if(a == nullptr)
+        return b;
+    if(b == nullptr)
+        return a;
+    if(a->prio >= b->prio){
+        a->right = merge(a->right, b);
+        update(a);
+        return a;
+    }
+    else{
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+}
+
+template<general_enctype T>
+auto rope<T>::split(node *n, size_t chr) -> std::pair<node *, node *>{
+    if(n == nullptr)
+        return {nullptr, nullptr};
+    size_t llen = len_of(n->left);
+    size_t plen = n->piece.length();
+    if(chr <= llen){
+        auto [a, b] = split(n->left, chr);
+        n->left = b;
+        update(n);
+        return {a, n};
+    }
+    else if(chr >= llen + plen){
+        auto [a, b] = split(n->right, chr - llen - plen);
+        n->right = a;
+        update(n);
+        return {n, b};
+    }
+    else{
+        /*
+         * The new node can take the same priority since all the nodes in n->right have a lower one
+         */
+        size_t off = chr - llen;
+        node *sec = new_node(n->piece.substring(off), n->prio);
+        n->piece = n->piece.substring(0, off);
+        sec->right = n->right;
+        n->right = nullptr;
+        update(n);
+        update(sec);
+        return {n, sec};
+    }
+}
+
+template<general_enctype T>
+bool rope<T>::append_small(node *n, const adv_string_view<T> &str){
+    if(n == nullptr)
+        return false;
+    bool ret;
+    if(n->right != nullptr)
+        ret = append_small(n->right, str);
+    else{
+        size_t psiz = n->piece.size();
+        if(psiz + str.size() > small_leaf)
+            return false;
+        byte tmp[small_leaf];
+        copy_bytes(tmp, n->piece.data(), psiz);
+        copy_bytes(tmp + psiz, str.data(), str.size());
+        n->piece = shared_string<T>{direct_build(const_tchar_pt<T>{tmp, format}, n->piece.length() + str.length(), psiz + str.size()), alloc};
+        ret = true;
+    }
+    if(ret)
+        update(n);
+    return ret;
+}
+
+template<general_enctype T>
+auto rope<T>::build_leaves(const adv_string_view<T> &str) -> node *{
+    shared_string<T> all{str, alloc};
+    node *ret = nullptr;
+    try{
+        const auto fine = all.select_end();
+        auto b = all.select_begin();
+        while(b != fine){
+            auto e = b;
+            if(format.is_fixed()){
+                size_t step = max_leaf / format.min_bytes();
+                e = all.select(b, step == 0 ? 1 : step);
+            }
+            else{
+                do{
+                    auto nx = all.select(e, 1);
+                    if(e != b && nx.nbytes() - b.nbytes() > max_leaf)
+                        break;
+                    e = nx;
+                }
+                while(e != fine);
+            }
+            ret = merge(ret, new_node(all.substring(b, e), next_prio()));
+            b = e;
+        }
+    }
+    catch(...){
+        destroy(ret);
+        throw;
+    }
+    return ret;
+}
+
+template<general_enctype T>
+void rope<T>::insert_view(size_t chr, const adv_string_view<T> &str){
+    if(chr > length())
+        throw std::out_of_range{"Out of range"};
+    if(str.size() == 0)
+        return;
+    auto [a, b] = split(root, chr);
+    try{
+        if(!append_small(a, str))
+            a = merge(a, build_leaves(str));
+    }
+    catch(...){
+        root = merge(a, b);
+        throw;
+    }
+    root = merge(a, b);
+}
+
+template<general_enctype T>
+void rope<T>::insert(size_t chr, rope &&r){
+    if(chr > length())
+        throw std::out_of_range{"Out of range"};
+    if(r.root == nullptr)
+        return;
+    if(r.alloc != alloc || !format.equalTo(r.format)){
+        for(adv_string_view<T> leaf : r){
+            insert_view(chr, leaf);
+            chr += leaf.length();
+        }
+        r.clear();
+        return;
+    }
+    auto [a, b] = split(root, chr);
+    root = merge(merge(a, r.root), b);
+    r.root = nullptr;
+}
+
+template<general_enctype T>
+void rope<T>::erase(size_t b, size_t e){
+    if(e > length())
+        e = length();
+    if(b >= e)
+        return;
+    auto [left, right] = split(root, e);
+    std::pair<node *, node *> res;
+    try{
+        res = split(left, b);
+    }
+    catch(...){
+        root = merge(left, right);
+        throw;
+    }
+    root = merge(res.first, right);
+    destroy(res.second);
+}
+
+template<general_enctype T>
+rope<T> rope<T>::split_at(size_t chr){
+    if(chr > length())
+        throw std::out_of_range{"Out of range"};
+    rope ret{format, alloc};
+    auto [a, b] = split(root, chr);
+    root = a;
+    ret.root = b;
+    return ret;
+}
+
+template<general_enctype T>
+void rope<T>::clear() noexcept{
+    destroy(root);
+    root = nullptr;
+}
+
+template<general_enctype T>
+rope<T>::rope(const rope &r) : root{nullptr}, format{r.format}, alloc{r.alloc}, seed{r.seed} {
+    root = clone(r.root);
+}
+
+template<general_enctype T>
+rope<T> &rope<T>::operator=(const rope &r){
+    if(this != &r){
+        node *cp = clone(r.root);
+        clear();
+        root = cp;
+        format = r.format;
+    }
+    return *this;
+}
+
+template<general_enctype T>
+rope<T> &rope<T>::operator=(rope &&r) noexcept{
+    if(this != &r){
+        clear();
+        root = r.root;
+        format = r.format;
+        alloc = r.alloc;
+        r.root = nullptr;
+    }
+    return *this;
+}
+
+template<general_enctype T>
+auto rope<T>::select(size_t chr) const -> position{
+    if(chr >= length())
+        throw std::out_of_range{"Out of range"};
+    const node *n = root;
+    size_t nchr = 0, nbytes = 0;
+    while(true){
+        size_t llen = len_of(n->left);
+        if(chr < llen){
+            n = n->left;
+            continue;
+        }
+        chr -= llen;
+        nchr += llen;
+        nbytes += siz_of(n->left);
+        if(chr < n->piece.length()){
+            adv_string_view<T> leaf = n->piece.view();
+            return position{nchr + chr, nbytes + leaf.select(chr).nbytes(), leaf, chr};
+        }
+        chr -= n->piece.length();
+        nchr += n->piece.length();
+        nbytes += n->piece.size();
+        n = n->right;
+    }
+}
+
+template<general_enctype T>
+typename T::ctype rope<T>::get_char(size_t chr) const{
+    position p = select(chr);
+    return p.leaf.get_char(p.leaf_nchr);
+}
+
+template<general_enctype T>
+adv_string<T> rope<T>::to_string(std::pmr::memory_resource *all) const{
+    size_t siz = size();
+    if(siz <= adv_string<T>::sso_capacity){
+        byte tmp[adv_string<T>::sso_capacity];
+        size_t off = 0;
+        for(adv_string_view<T> leaf : *this){
+            copy_bytes(tmp + off, leaf.data(), leaf.size());
+            off += leaf.size();
+        }
+        return adv_string<T>{direct_build(const_tchar_pt<T>{tmp, format}, length(), siz), all};
+    }
+    basic_ptr buf{siz, all};
+    size_t off = 0;
+    for(adv_string_view<T> leaf : *this){
+        copy_bytes(buf.memory + off, leaf.data(), leaf.size());
+        off += leaf.size();
+    }
+    return direct_build_dyn(std::move(buf), length(), siz, format);
+}
@@ -0,0 +1,118 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <atomic>
+#include <strsuite/encmetric/dynstring.hpp>
+
+namespace sts{
+
+/*
+ * Reference counted immutable memory block.
+ *
+ * Data can be stored right after the block header (create) or inside an adopted basic_ptr (adopt),
+ * the block itself is allocated with the same memory resource of its data
+ */
+class shared_block{
+    private:
+        std::atomic<size_t> refs;
+        std::pmr::memory_resource *alloc;
+        size_t dim;
+        basic_ptr owned;
+
+        shared_block(std::pmr::memory_resource *, size_t, basic_ptr) noexcept;
+    public:
+        shared_block(const shared_block &) = delete;
+        shared_block &operator=(const shared_block &) = delete;
+
+        static shared_block *create(const byte *, size_t, std::pmr::memory_resource *);
+        static shared_block *adopt(basic_ptr);
+
+        const byte *data() const noexcept{
+            return owned.memory != nullptr ? owned.memory : reinterpret_cast<const byte *>(this + 1);
+        }
+        size_t use_count() const noexcept{ return refs.load(std::memory_order_relaxed);}
+        std::pmr::memory_resource *get_allocator() const noexcept{ return alloc;}
+
+        void acquire() noexcept{
+            refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        /*
+         * Destroys the block when the last reference is released
+         */
+        void release() noexcept;
+};
+
+/*
+ * Immutable string with shared ownership: copies and substrings only increment an atomic
+ * counter and keep the underlying buffer alive
+ */
+template<general_enctype T>
+class shared_string : public adv_string_view<T>{
+    private:
+        shared_block *blk;
+
+        shared_string(shared_block *b, const adv_string_view<T> &v) noexcept : adv_string_view<T>{v}, blk{b} {
+            if(blk != nullptr)
+                blk->acquire();
+        }
+        static adv_string_view<T> block_view(const shared_block *b, EncMetric_info<T> f, size_t len, size_t siz) noexcept{
+            return direct_build(const_tchar_pt<T>{b == nullptr ? nullptr : b->data(), f}, len, siz);
+        }
+    public:
+        using placeholder = typename adv_string_view<T>::placeholder;
+
+        explicit shared_string(EncMetric_info<T> f) noexcept : adv_string_view<T>{f}, blk{nullptr} {}
+        explicit shared_string() noexcept requires strong_enctype<T> : shared_string{EncMetric_info<T>{}} {}
+        /*
+         * Copies the string (only once)
+         */
+        shared_string(const adv_string_view<T> &, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        /*
+         * Takes the buffer of an existing string without copying it
+         */
+        shared_string(adv_string<T> &&);
+        shared_string(const shared_string &s) noexcept : shared_string{s.blk, s} {}
+        shared_string(shared_string &&s) noexcept : adv_string_view<T>{s}, blk{s.blk} {
+            s.blk = nullptr;
+        }
+        ~shared_string(){
+            if(blk != nullptr)
+                blk->release();
+        }
+        shared_string &operator=(const shared_string &);
+        shared_string &operator=(shared_string &&) noexcept;
+
+        adv_string_view<T> view() const noexcept{ return *this;}
+        size_t use_count() const noexcept{ return blk == nullptr ? 0 : blk->use_count();}
+        std::pmr::memory_resource *get_allocator() const noexcept{ return blk == nullptr ? std::pmr::get_default_resource() : blk->get_allocator();}
+
+        /*
+         * Substrings share the same buffer
+         */
+        shared_string substring(placeholder b, placeholder e) const{ return shared_string{blk, adv_string_view<T>::substring(b, e)};}
+        shared_string substring(placeholder b, size_t e) const{ return shared_string{blk, adv_string_view<T>::substring(b, e)};}
+        shared_string substring(size_t b, placeholder e) const{ return shared_string{blk, adv_string_view<T>::substring(b, e)};}
+        shared_string substring(size_t b, size_t e) const{ return shared_string{blk, adv_string_view<T>::substring(b, e)};}
+        shared_string substring(placeholder b) const{ return shared_string{blk, adv_string_view<T>::substring(b)};}
+        shared_string substring(size_t b) const{ return shared_string{blk, adv_string_view<T>::substring(b)};}
+};
+
+using wshared_str = shared_string<WIDEchr>;
+
+#include <strsuite/encmetric/shared_string.tpp>
+}
@@ -0,0 +1,63 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T>
+shared_string<T>::shared_string(const adv_string_view<T> &str, std::pmr::memory_resource *alloc) : adv_string_view<T>{str.raw_format()}, blk{nullptr} {
+    if(str.size() == 0)
+        return;
+    blk = shared_block::create(str.data(), str.size(), alloc);
+    adv_string_view<T>::operator=(block_view(blk, str.raw_format(), str.length(), str.size()));
+}
+
+template<general_enctype T>
+shared_string<T>::shared_string(adv_string<T> &&str) : adv_string_view<T>{str.raw_format()}, blk{nullptr} {
+    if(str.size() == 0)
+        return;
+    size_t len = str.length();
+    size_t siz = str.size();
+    if(str.is_local()){
+        blk = shared_block::create(str.data(), siz, str.get_allocator());
+        str.clear();
+    }
+    else
+        blk = shared_block::adopt(str.release());
+    adv_string_view<T>::operator=(block_view(blk, str.raw_format(), len, siz));
+}
+
+template<general_enctype T>
+shared_string<T> &shared_string<T>::operator=(const shared_string &s){
+    if(s.blk != nullptr)
+        s.blk->acquire();
+    if(blk != nullptr)
+        blk->release();
+    blk = s.blk;
+    adv_string_view<T>::operator=(s);
+    return *this;
+}
+
+template<general_enctype T>
+shared_string<T> &shared_string<T>::operator=(shared_string &&s) noexcept{
+    if(this != &s){
+        if(blk != nullptr)
+            blk->release();
+        blk = s.blk;
+        s.blk = nullptr;
+        adv_string_view<T>::operator=(s);
+    }
+    return *this;
+}
@@ -0,0 +1,72 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/resources.hpp>
+#include <strsuite/encmetric/dynstring.hpp>
+
+namespace sts{
+
+/*
+ * Arena for strings that all die together.
+ *
+ * It can be used as a normal memory resource, but its alloc_string members allocate encoded
+ * bytes without alignment padding and without any virtual call. Memory is given back to
+ * upstream only when the arena is destroyed or release() is called, so destroying the
+ * strings themselves is almost free.
+ *
+ * Strings allocated here must not outlive the arena
+ */
+class string_arena : public monotonic_expand_resource{
+    public:
+        explicit string_arena(std::size_t chunk_dim = 4096, std::pmr::memory_resource *up = std::pmr::get_default_resource()) : monotonic_expand_resource{chunk_dim, up} {}
+
+        /*
+         * Unaligned allocation, you can release it with deallocate
+         */
+        byte *allocate_bytes(std::size_t siz){ return bump_bytes(siz);}
+
+        /*
+         * Copies the bytes inside the arena
+         */
+        basic_ptr allocate_ptr(const byte *data, std::size_t siz){
+            basic_ptr ret{this};
+            if(siz > 0){
+                ret.memory = allocate_bytes(siz);
+                ret.dimension = siz;
+                copy_bytes(ret.memory, data, siz);
+            }
+            return ret;
+        }
+
+        template<general_enctype T>
+        adv_string<T> alloc_string(const adv_string_view<T> &str){
+            if(str.size() <= adv_string<T>::sso_capacity)
+                return adv_string<T>{str, this};
+            return direct_build_dyn(allocate_ptr(str.data(), str.size()), str.length(), str.size(), str.raw_format());
+        }
+        template<strong_enctype T, typename U>
+        adv_string<T> alloc_string(const U *b, std::size_t siz, std::size_t len){
+            return alloc_string(adv_string_view<T>{const_tchar_pt<T>{b}, siz, len});
+        }
+        template<widenc T, typename U>
+        adv_string<T> alloc_string(const U *b, const EncMetric<typename T::ctype> *f, std::size_t siz, std::size_t len){
+            return alloc_string(adv_string_view<T>{const_tchar_pt<T>{b, f}, siz, len});
+        }
+};
+
+}
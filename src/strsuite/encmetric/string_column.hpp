@@ -0,0 +1,127 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include <strsuite/encmetric/basic_ptr.hpp>
+#include <strsuite/encmetric/enc_string.hpp>
+
+namespace sts{
+
+/*
+ * Append-only column of strings with the same encoding.
+ *
+ * All the strings are stored one after the other inside a single buffer, the i-th string is
+ * placed between offsets[i] and offsets[i+1]. Offset should be uint32_t or uint64_t and limits the
+ * total size of the column. Character lengths can be stored too, otherwise they're computed at
+ * each access.
+ */
+template<general_enctype T, std::unsigned_integral Offset = std::uint32_t>
+class string_column{
+    private:
+        basic_ptr blob;
+        size_t bsiz;
+        std::pmr::vector<Offset> offsets;
+        std::pmr::vector<Offset> lengths;
+        bool cache_len;
+        EncMetric_info<T> format;
+
+        void push_raw(const byte *, size_t siz, size_t len);
+    public:
+        static constexpr std::uint32_t image_magic = 0x43535453u;
+        struct image_header{
+            std::uint32_t magic;
+            std::uint32_t offset_size;
+            std::uint64_t rows;
+            std::uint64_t bytes;
+            std::uint64_t has_lengths;
+        };
+
+        explicit string_column(EncMetric_info<T> f, bool cache_lengths = true, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        explicit string_column(bool cache_lengths = true, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T> : string_column{EncMetric_info<T>{}, cache_lengths, alloc} {}
+        explicit string_column(const EncMetric<typename T::ctype> *f, bool cache_lengths = true, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires widenc<T> : string_column{EncMetric_info<T>{f}, cache_lengths, alloc} {}
+
+        size_t size() const noexcept{ return offsets.size() - 1;}
+        bool empty() const noexcept{ return size() == 0;}
+        /*
+         * Total size in bytes of all the strings
+         */
+        size_t bytes() const noexcept{ return bsiz;}
+        bool has_lengths() const noexcept{ return cache_len;}
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+        std::pmr::memory_resource *get_allocator() const noexcept{ return blob.get_allocator();}
+
+        void reserve(size_t rows, size_t nbytes);
+        void shrink_to_fit();
+        void clear() noexcept;
+
+        template<general_enctype S>
+        size_t push_back(const adv_string_view<S> &str){
+            adv_string_view<T> r = str.rebase(format);
+            push_raw(r.data(), r.size(), r.length());
+            return size() - 1;
+        }
+        /*
+         * Appends the content of a string_stream as a new string and empties it
+         */
+        template<typename Stream> requires requires(Stream &s){ {s.view()} -> std::convertible_to<adv_string_view<T>>; s.discard();}
+        size_t append(Stream &stream){
+            size_t ret = push_back(stream.view());
+            stream.discard();
+            return ret;
+        }
+        void append(const string_column &);
+
+        size_t length(size_t i) const;
+        size_t size(size_t i) const{ return offsets[i+1] - offsets[i];}
+        adv_string_view<T> operator[](size_t i) const{
+            return direct_build(const_tchar_pt<T>{blob.memory + offsets[i], format}, length(i), size(i));
+        }
+        adv_string_view<T> at(size_t i) const{
+            if(i >= size())
+                throw out_of_range{"Out of range"};
+            return (*this)[i];
+        }
+
+        /*
+         * Returns a permutation p such that (*this)[p[0]], (*this)[p[1]], ... is sorted
+         */
+        std::vector<size_t> sorted_index() const;
+        template<typename Compare>
+        std::vector<size_t> sorted_index(Compare) const;
+        /*
+         * The i-th string becomes the perm[i]-th old string, perm must contain each index exactly once
+         */
+        void permute(const std::vector<size_t> &perm);
+        void sort(){ permute(sorted_index());}
+
+        /*
+         * Flat memory image: header, offsets, lengths (if cached) and the strings.
+         * Numbers are stored with the endianess of the current machine
+         */
+        size_t image_size() const noexcept;
+        void save(byte *) const;
+        static string_column load(const byte *, size_t, EncMetric_info<T>, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        static string_column load(const byte *b, size_t siz, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T> { return load(b, siz, EncMetric_info<T>{}, alloc);}
+};
+
+#include <strsuite/encmetric/string_column.tpp>
+}
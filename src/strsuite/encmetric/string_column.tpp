@@ -0,0 +1,207 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+template<general_enctype T, std::unsigned_integral Offset>
+string_column<T, Offset>::string_column(EncMetric_info<T> f, bool cl, std::pmr::memory_resource *alloc) : blob{alloc}, bsiz{0}, offsets{alloc}, lengths{alloc}, cache_len{cl}, format{f} {
+    offsets.push_back(0);
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::push_raw(const byte *b, size_t siz, size_t len){
+    if(siz > std::numeric_limits<Offset>::max() - bsiz)
+        throw out_of_range{"Column is too big"};
+    if(blob.dimension < bsiz + siz)
+        blob.exp_fit(bsiz + siz);
+    if(siz > 0)
+        copy_bytes(blob.memory + bsiz, b, siz);
+    /*
+     * Bytes after bsiz are not part of the column, so nothing changes until both tables have grown
+     */
+    offsets.push_back(static_cast<Offset>(bsiz + siz));
+    if(cache_len){
+        try{
+            lengths.push_back(static_cast<Offset>(len));
+        }
+        catch(...){
+            offsets.pop_back();
+            throw;
+        }
+    }
+    bsiz += siz;
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::append(const string_column &c){
+    if(c.bsiz > std::numeric_limits<Offset>::max() - bsiz)
+        throw out_of_range{"Column is too big"};
+    /*
+     * c may be this column, so its size must be read before pushing anything.
+     * reserve also ensures that blob is not moved while copying
+     */
+    size_t n = c.size();
+    reserve(n, c.bsiz);
+    for(size_t i=0; i<n; i++)
+        push_raw(c.blob.memory + c.offsets[i], c.size(i), cache_len ? c.length(i) : 0);
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::reserve(size_t rows, size_t nbytes){
+    if(blob.dimension < bsiz + nbytes)
+        blob.reallocate(bsiz + nbytes);
+    offsets.reserve(offsets.size() + rows);
+    if(cache_len)
+        lengths.reserve(lengths.size() + rows);
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::shrink_to_fit(){
+    if(bsiz == 0)
+        blob.free();
+    else if(blob.dimension > bsiz)
+        blob.reallocate(bsiz);
+    offsets.shrink_to_fit();
+    lengths.shrink_to_fit();
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::clear() noexcept{
+    bsiz = 0;
+    offsets.resize(1);
+    lengths.clear();
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+size_t string_column<T, Offset>::length(size_t i) const{
+    if(cache_len)
+        return lengths[i];
+    if(format.is_fixed())
+        return size(i) / format.min_bytes();
+    return deduce_lens(const_tchar_pt<T>{blob.memory + offsets[i], format}, size(i)).len;
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+template<typename Compare>
+std::vector<size_t> string_column<T, Offset>::sorted_index(Compare comp) const{
+    std::vector<size_t> ret(size());
+    for(size_t i=0; i<ret.size(); i++)
+        ret[i] = i;
+    std::stable_sort(ret.begin(), ret.end(), [this, &comp](size_t a, size_t b){ return comp((*this)[a], (*this)[b]);});
+    return ret;
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+std::vector<size_t> string_column<T, Offset>::sorted_index() const{
+    return sorted_index([](const adv_string_view<T> &a, const adv_string_view<T> &b){ return a < b;});
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::permute(const std::vector<size_t> &perm){
+    if(perm.size() != size())
+        throw out_of_range{"Invalid permutation"};
+    basic_ptr nblob{bsiz, blob.get_allocator()};
+    std::pmr::vector<Offset> noff{offsets.get_allocator()};
+    std::pmr::vector<Offset> nlen{lengths.get_allocator()};
+    noff.reserve(offsets.size());
+    noff.push_back(0);
+    if(cache_len)
+        nlen.reserve(lengths.size());
+    size_t pos = 0;
+    for(size_t i : perm){
+        if(i >= size())
+            throw out_of_range{"Invalid permutation"};
+        if(size(i) > 0)
+            copy_bytes(nblob.memory + pos, blob.memory + offsets[i], size(i));
+        pos += size(i);
+        noff.push_back(static_cast<Offset>(pos));
+        if(cache_len)
+            nlen.push_back(lengths[i]);
+    }
+    blob = std::move(nblob);
+    offsets = std::move(noff);
+    lengths = std::move(nlen);
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+size_t string_column<T, Offset>::image_size() const noexcept{
+    return sizeof(image_header) + offsets.size() * sizeof(Offset) + lengths.size() * sizeof(Offset) + bsiz;
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+void string_column<T, Offset>::save(byte *b) const{
+    image_header head{image_magic, sizeof(Offset), size(), bsiz, cache_len ? 1u : 0u};
+    copy_bytes(b, reinterpret_cast<const byte *>(&head), sizeof(image_header));
+    b += sizeof(image_header);
+    copy_bytes(b, reinterpret_cast<const byte *>(offsets.data()), offsets.size() * sizeof(Offset));
+    b += offsets.size() * sizeof(Offset);
+    if(cache_len){
+        copy_bytes(b, reinterpret_cast<const byte *>(lengths.data()), lengths.size() * sizeof(Offset));
+        b += lengths.size() * sizeof(Offset);
+    }
+    if(bsiz > 0)
+        copy_bytes(b, blob.memory, bsiz);
+}
+
+template<general_enctype T, std::unsigned_integral Offset>
+string_column<T, Offset> string_column<T, Offset>::load(const byte *b, size_t siz, EncMetric_info<T> f, std::pmr::memory_resource *alloc){
+    image_header head;
+    if(siz < sizeof(image_header))
+        throw out_of_range{"Invalid column image"};
+    copy_bytes(reinterpret_cast<byte *>(&head), b, sizeof(image_header));
+    if(head.magic != image_magic || head.offset_size != sizeof(Offset))
+        throw out_of_range{"Invalid column image"};
+    /*
+     * Header fields are untrusted, so they're compared with the available space before any sum
+     */
+    size_t slots = (siz - sizeof(image_header)) / sizeof(Offset);
+    if(head.rows >= slots)
+        throw out_of_range{"Invalid column image"};
+    size_t nlens = head.has_lengths != 0 ? head.rows : 0;
+    if(nlens > slots - head.rows - 1)
+        throw out_of_range{"Invalid column image"};
+    size_t tables = (head.rows + 1 + nlens) * sizeof(Offset);
+    if(head.bytes > siz - sizeof(image_header) - tables)
+        throw out_of_range{"Invalid column image"};
+
+    string_column ret{f, head.has_lengths != 0, alloc};
+    b += sizeof(image_header);
+    ret.offsets.resize(head.rows + 1);
+    copy_bytes(reinterpret_cast<byte *>(ret.offsets.data()), b, (head.rows + 1) * sizeof(Offset));
+    b += (head.rows + 1) * sizeof(Offset);
+    if(ret.offsets[0] != 0 || ret.offsets[head.rows] != head.bytes)
+        throw out_of_range{"Invalid column image"};
+    for(size_t i=0; i<head.rows; i++){
+        if(ret.offsets[i] > ret.offsets[i+1])
+            throw out_of_range{"Invalid column image"};
+    }
+    if(nlens > 0){
+        ret.lengths.resize(nlens);
+        copy_bytes(reinterpret_cast<byte *>(ret.lengths.data()), b, nlens * sizeof(Offset));
+        b += nlens * sizeof(Offset);
+        for(size_t i=0; i<nlens; i++){
+            if(ret.lengths[i] > ret.size(i) / f.min_bytes())
+                throw out_of_range{"Invalid column image"};
+        }
+    }
+    if(head.bytes > 0){
+        ret.blob.reallocate(head.bytes);
+        copy_bytes(ret.blob.memory, b, head.bytes);
+    }
+    ret.bsiz = head.bytes;
+    return ret;
+}
@@ -46,6 +46,10 @@ adv_string<T> adv_formatter<T, Formatter>::format(const adv_string_view<T> &str,
     adv_string_view<T> empty{stream.raw_format()};
     if(str.length() == 0)
         return adv_string<T>{empty, std::pmr::get_default_resource()};
+    /*
+     * The output is usually slightly longer than the format string
+     */
+    stream.reserve(str.size());
     const auto fine = str.select_end();
     auto mid = str.select_begin();
     bool param = false;
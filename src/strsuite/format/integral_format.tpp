@@ -30,11 +30,16 @@
             out.ctype_write('0'_uni);
         }
         auto nval = static_cast<std::make_unsigned_t<I>>(val);
+        size_t ndigits = 0;
         do{
             stack.push_front(opt.convert_unit(nval));
             nval /= opt.base;
+            ndigits++;
         }
         while(nval > 0);
+        if constexpr(requires(Stream &s, size_t n){ s.reserve_chars(n);}){
+            out.reserve_chars(ndigits + 1);
+        }
 
         if(minus){
             out.ctype_write('-'_uni);
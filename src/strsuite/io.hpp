@@ -19,6 +19,12 @@
 #include <strsuite/io/enc_io_core.hpp>
 //#include <strsuite/io/integral_format.hpp>
 #include <strsuite/io/cio_stream.hpp>
+#include <strsuite/io/line_reader.hpp>
+#include <strsuite/io/spill_stream.hpp>
+#include <strsuite/io/mapped_file.hpp>
+#include <strsuite/io/file_stream.hpp>
+#include <strsuite/io/transcode_stream.hpp>
+#include <strsuite/io/stream_validator.hpp>
 
 namespace sts{
 
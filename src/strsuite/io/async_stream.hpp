@@ -0,0 +1,96 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/io/reactor.hpp>
+#include <strsuite/io/file_stream.hpp>
+
+namespace sts{
+
+/*
+ * Asynchronous input stream on a nonblocking descriptor.
+ *
+ * Received bytes are kept in the buffer until they form complete characters, so a read can be
+ * suspended at any byte offset (also inside a multibyte character) without losing data
+ */
+template<general_enctype T>
+class async_istream{
+    private:
+        reactor &rt;
+        async_fd fd;
+        EncMetric_info<T> format;
+        basic_ptr buffer;
+        basic_ptr nl;
+        size_t fir, las;
+        bool ended;
+
+        /*
+         * Reads once, returns false if the descriptor isn't ready
+         */
+        bool read_more();
+        size_t find_newline() const noexcept;
+        adv_string_view<T> complete_chars(size_t, size_t) const;
+    public:
+        static constexpr size_t default_buffer = 1 << 12;
+
+        async_istream(reactor &r, std::intptr_t d, EncMetric_info<T>, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        async_istream(reactor &r, std::intptr_t d, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>
+            : async_istream{r, d, EncMetric_info<T>{}, bufsiz, alloc} {}
+
+        /*
+         * Reads a line, the last line may not end with a newline.
+         * Throws IOEOF if the descriptor is closed and there aren't other characters
+         */
+        task<adv_string<T>> read_line(bool keep_nl = false, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        /*
+         * Reads at least one and at most nchr characters
+         */
+        task<adv_string<T>> read_chars(size_t nchr, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+
+        bool eof() const noexcept{ return ended && fir == las;}
+        EncMetric_info<T> encmetric() const noexcept{ return format;}
+};
+
+/*
+ * Asynchronous output stream on a nonblocking descriptor.
+ *
+ * Written strings must be valid until the write ends
+ */
+template<general_enctype T>
+class async_ostream{
+    private:
+        reactor &rt;
+        async_fd fd;
+        EncMetric_info<T> format;
+        basic_ptr nl;
+    public:
+        async_ostream(reactor &r, std::intptr_t d, EncMetric_info<T>, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        async_ostream(reactor &r, std::intptr_t d, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>
+            : async_ostream{r, d, EncMetric_info<T>{}, alloc} {}
+
+        /*
+         * Writes all the string, returns its size
+         */
+        task<size_t> write(adv_string_view<T> str);
+        task<size_t> write_line(adv_string_view<T> str);
+
+        adv_string_view<T> newline() const noexcept{ return direct_build(const_tchar_pt<T>{nl.memory, format}, 1, nl.dimension);}
+        EncMetric_info<T> encmetric() const noexcept{ return format;}
+};
+
+#include <strsuite/io/async_stream.tpp>
+}
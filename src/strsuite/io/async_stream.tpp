@@ -0,0 +1,143 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T>
+async_istream<T>::async_istream(reactor &r, std::intptr_t d, EncMetric_info<T> f, size_t bufsiz, std::pmr::memory_resource *alloc)
+    : rt{r}, fd{d}, format{f}, buffer{file_stream_bufsiz(bufsiz), alloc}, nl{file_stream_newline(f, alloc)}, fir{0}, las{0}, ended{false} {}
+
+template<general_enctype T>
+bool async_istream<T>::read_more(){
+    if(fir == las)
+        fir = las = 0;
+    else if(las == buffer.dimension){
+        if(fir > 0){
+            move_bytes(buffer.memory, buffer.memory + fir, las - fir);
+            las -= fir;
+            fir = 0;
+        }
+        else
+            buffer.exp_fit(buffer.dimension + 1);
+    }
+    try{
+        las += fd.read_wrap(buffer.memory + las, buffer.dimension - las);
+    }
+    catch(IOAGAIN &){
+        return false;
+    }
+    catch(IOEOF &){
+        ended = true;
+    }
+    return true;
+}
+
+template<general_enctype T>
+size_t async_istream<T>::find_newline() const noexcept{
+    return sts::find_newline(buffer.memory + fir, las - fir, nl.memory, nl.dimension, format.min_bytes());
+}
+
+template<general_enctype T>
+adv_string_view<T> async_istream<T>::complete_chars(size_t siz, size_t nchr) const{
+    dimensions d = measure_chars(format, buffer.memory + fir, siz, nchr);
+    return adv_string_view<T>{const_tchar_pt<T>{buffer.memory + fir, format}, d.siz};
+}
+
+template<general_enctype T>
+task<adv_string<T>> async_istream<T>::read_line(bool keep_nl, std::pmr::memory_resource *alloc){
+    string_stream<T> stream{format, alloc};
+    while(true){
+        size_t avail = las - fir;
+        size_t off = find_newline();
+        if(off < avail){
+            stream.string_write(complete_chars(keep_nl ? off + nl.dimension : off, SIZE_MAX));
+            fir += off + nl.dimension;
+            co_return stream.move();
+        }
+        if(ended){
+            if(avail == 0 && stream.size() == 0)
+                throw IOEOF{};
+            adv_string_view<T> rest = complete_chars(avail, SIZE_MAX);
+            if(rest.size() < avail)
+                throw IOIncomplete{};
+            stream.string_write(rest);
+            fir = las;
+            co_return stream.move();
+        }
+        /*
+         * Only complete characters are moved out of the buffer, the last bytes could be
+         * the beginning of a newline or of a character
+         */
+        size_t keep = avail < nl.dimension ? avail : nl.dimension - 1;
+        adv_string_view<T> part = complete_chars(avail - keep, SIZE_MAX);
+        stream.string_write(part);
+        fir += part.size();
+        if(!read_more())
+            co_await rt.wait(fd.native(), io_event::read);
+    }
+}
+
+template<general_enctype T>
+task<adv_string<T>> async_istream<T>::read_chars(size_t nchr, std::pmr::memory_resource *alloc){
+    string_stream<T> stream{format, alloc};
+    while(nchr > 0){
+        adv_string_view<T> part = complete_chars(las - fir, nchr);
+        if(part.length() > 0){
+            stream.string_write(part);
+            fir += part.size();
+            break;
+        }
+        if(ended){
+            if(fir == las)
+                throw IOEOF{};
+            throw IOIncomplete{};
+        }
+        if(!read_more())
+            co_await rt.wait(fd.native(), io_event::read);
+    }
+    co_return stream.move();
+}
+
+template<general_enctype T>
+async_ostream<T>::async_ostream(reactor &r, std::intptr_t d, EncMetric_info<T> f, std::pmr::memory_resource *alloc)
+    : rt{r}, fd{d}, format{f}, nl{file_stream_newline(f, alloc)} {}
+
+template<general_enctype T>
+task<size_t> async_ostream<T>::write(adv_string_view<T> str){
+    /*
+     * done can stop inside a character, the remaining bytes are written when fd is ready again
+     */
+    size_t done = 0;
+    while(done < str.size()){
+        bool ready = true;
+        try{
+            done += fd.write_wrap(str.data() + done, str.size() - done);
+        }
+        catch(IOAGAIN &){
+            ready = false;
+        }
+        if(!ready)
+            co_await rt.wait(fd.native(), io_event::write);
+    }
+    co_return str.size();
+}
+
+template<general_enctype T>
+task<size_t> async_ostream<T>::write_line(adv_string_view<T> str){
+    size_t ret = co_await write(str);
+    ret += co_await write(newline());
+    co_return ret;
+}
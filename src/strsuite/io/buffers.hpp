@@ -18,6 +18,7 @@
 */
 #include <strsuite/encmetric/chite.hpp>
 #include <strsuite/encmetric/byte_tools.hpp>
+#include <strsuite/io/enc_io_exc.hpp>
 #include <cstring>
 
 namespace sts{
@@ -72,6 +73,14 @@ class basic_buffer{
         void raw_fir_step(size_t inc){
             fir += inc;
             siz -= inc;
+            /*
+             * Empty buffers can restart from the beginning without moving anything
+             */
+            if(siz == 0){
+                rem += fir;
+                fir = 0;
+                las = 0;
+            }
         }
         void raw_las_step(size_t inc){
             las += inc;
@@ -96,24 +105,29 @@ class basic_buffer{
             las = siz;
             rem += skip;
         }
+        /*
+         * Data is moved only when there isn't enough space at the end of the buffer
+         */
+        void rewind_for(size_t nrem){
+            if(rem < nrem)
+                rewind();
+        }
 
         size_t ask_size(size_t nl) requires read{
-            if(fir != 0)
-                rewind();
             if(siz >= nl)
                 return nl;
             else{
+                rewind_for(nl - siz);
                 mycast()->inc_siz(nl - siz);
                 return siz >= nl ? nl : siz;
             }
         }
 
         void force_size(size_t nl) requires read{
-            if(fir != 0)
-                rewind();
             if(siz >= nl)
                 return;
             else{
+                rewind_for(nl - siz);
                 mycast()->inc_siz(nl - siz);
                 if(siz < nl)
                     throw IOFail{};
@@ -131,8 +145,7 @@ class basic_buffer{
                     get = true;
                 }
                 catch(buffer_small &e){
-                    if(fir != 0)
-                        rewind();
+                    rewind_for(e.get_required_size());
                     mycast()->inc_siz(e.get_required_size());
                 }
             }
@@ -147,8 +160,7 @@ class basic_buffer{
          * returns minimum between rem and nl
          */
         size_t ask_rem(size_t nl) requires write{
-            if(fir > 0)
-                rewind();
+            rewind_for(nl);
             if(rem >= nl)
                 return nl;
             else{
@@ -157,8 +169,7 @@ class basic_buffer{
             }
         }
         void force_rem(size_t nl) requires write{
-            if(fir > 0)
-                rewind();
+            rewind_for(nl);
             if(rem >= nl)
                 return;
             else{
@@ -169,5 +180,179 @@ class basic_buffer{
         }
 };
 
+    /*
+     * Circular buffer, data never needs to be moved
+     *
+     *   |DATA|-----------------|abcdefghijklmnopqrs|
+     *   ↑    ↑                 ↑                   ↑
+     * base  las               fir                 dim
+     *
+     * Data may wrap around the end of the buffer, use linear() in order to get a contiguous copy
+     * of characters crossing the wrap point.
+     *
+     * If read=true then U must have inc_siz(size_t) member function, that should fill the free
+     * space returned by free_chunk()
+     * If write=true then U must have inc_rem(size_t) member function, that should consume data
+     * returned by data_chunk()
+     */
+template<typename U, bool read, bool write>
+class ring_buffer{
+    protected:
+        U *mycast() noexcept{ return static_cast<U *>(this);}
+        U const *mycast() const noexcept{ return static_cast<U const *>(this);}
+    public:
+        /*
+         * Maximum character dimension supported by get_chLen
+         */
+        static constexpr size_t scratch_size = 16;
+
+        byte *base;
+        size_t dim;
+        size_t fir, siz;
+
+        ring_buffer(byte *b, size_t d) noexcept : base{b}, dim{d}, fir{0}, siz{0} {}
+
+        size_t rem() const noexcept{ return dim - siz;}
+        size_t las() const noexcept{
+            size_t ret = fir + siz;
+            return ret >= dim ? ret - dim : ret;
+        }
+        /*
+         * Contiguous data starting from fir
+         */
+        size_t data_chunk() const noexcept{
+            return siz < dim - fir ? siz : dim - fir;
+        }
+        /*
+         * Contiguous free space starting from las
+         */
+        size_t free_chunk() const noexcept{
+            if(siz == dim)
+                return 0;
+            size_t l = las();
+            return l >= fir ? dim - l : fir - l;
+        }
+
+        void discard_all() noexcept{
+            fir = 0;
+            siz = 0;
+        }
+        void raw_fir_step(size_t inc) noexcept{
+            fir += inc;
+            if(fir >= dim)
+                fir -= dim;
+            siz -= inc;
+            if(siz == 0)
+                fir = 0;
+        }
+        void raw_las_step(size_t inc) noexcept{
+            siz += inc;
+        }
+
+        /*
+         * Moves n <= siz bytes into b
+         */
+        void copy_out(byte *b, size_t n) noexcept{
+            size_t first = data_chunk();
+            if(first > n)
+                first = n;
+            copy_bytes(b, base + fir, first);
+            if(n > first)
+                copy_bytes(b + first, base, n - first);
+            raw_fir_step(n);
+        }
+        /*
+         * Appends n <= rem() bytes from b
+         */
+        void copy_in(const byte *b, size_t n) noexcept{
+            size_t l = las();
+            size_t first = dim - l;
+            if(first > n)
+                first = n;
+            copy_bytes(base + l, b, first);
+            if(n > first)
+                copy_bytes(base, b + first, n - first);
+            raw_las_step(n);
+        }
+        /*
+         * Pointer to the first n <= siz bytes, if they cross the wrap point they're copied into scratch
+         */
+        const byte *linear(size_t n, byte *scratch) const noexcept{
+            size_t first = data_chunk();
+            if(first >= n)
+                return base + fir;
+            copy_bytes(scratch, base + fir, first);
+            copy_bytes(scratch + first, base, n - first);
+            return scratch;
+        }
+
+        size_t ask_size(size_t nl) requires read{
+            if(siz < nl)
+                mycast()->inc_siz(nl - siz);
+            return siz >= nl ? nl : siz;
+        }
+        void force_size(size_t nl) requires read{
+            while(siz < nl){
+                size_t old = siz;
+                mycast()->inc_siz(nl - siz);
+                if(siz == old)
+                    throw IOFail{};
+            }
+        }
+
+        template<typename T>
+        uint get_chLen(EncMetric_info<T> rf) requires read{
+            byte scratch[scratch_size];
+            uint ret;
+            force_size(rf.min_bytes());
+            while(true){
+                size_t avail = siz < scratch_size ? siz : scratch_size;
+                try{
+                    ret = rf.chLen(linear(avail, scratch), avail);
+                    break;
+                }
+                catch(buffer_small &e){
+                    if(avail + e.get_required_size() > scratch_size)
+                        throw IOBufsmall{scratch_size};
+                    force_size(avail + e.get_required_size());
+                }
+            }
+            force_size(ret);
+            return ret;
+        }
+
+        /*
+         * Length of the next character if it's already entirely stored, 0 otherwise. No data is read
+         */
+        template<typename T>
+        uint buffered_chLen(EncMetric_info<T> rf) const noexcept requires read{
+            byte scratch[scratch_size];
+            size_t avail = siz < scratch_size ? siz : scratch_size;
+            if(avail < rf.min_bytes())
+                return 0;
+            try{
+                uint ret = rf.chLen(linear(avail, scratch), avail);
+                return ret <= avail ? ret : 0;
+            }
+            catch(...){
+                return 0;
+            }
+        }
+
+        size_t ask_rem(size_t nl) requires write{
+            if(rem() < nl)
+                mycast()->inc_rem(nl - rem());
+            return rem() >= nl ? nl : rem();
+        }
+        void force_rem(size_t nl) requires write{
+            while(rem() < nl){
+                size_t old = rem();
+                mycast()->inc_rem(nl - rem());
+                if(rem() == old)
+                    throw IOFail{};
+            }
+        }
+};
+
 
 }
@@ -16,6 +16,8 @@
     You should have received a copy of the GNU Lesser General Public License
     along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
 */
+#include <limits>
+#include <span>
 #include <strsuite/encmetric/dynstring.hpp>
 #include <strsuite/io/enc_io_exc.hpp>
 
@@ -62,6 +64,37 @@ size_t force_byte_write(T &stream, const byte *b, size_t siz){
     return ret;
 }
 
+/*
+ * Number of complete characters at the beginning of b, reading at most maxsiz bytes and maxlen characters.
+ *
+ * Characters are supposed to be correctly encoded
+ */
+template<general_enctype T>
+dimensions measure_chars(EncMetric_info<T> f, const byte *b, size_t maxsiz, size_t maxlen){
+    dimensions ret{};
+    if(f.is_fixed()){
+        ret.len = maxsiz / f.min_bytes();
+        if(ret.len > maxlen)
+            ret.len = maxlen;
+        ret.siz = ret.len * f.min_bytes();
+        return ret;
+    }
+    while(ret.len < maxlen && ret.siz < maxsiz){
+        uint chl;
+        try{
+            chl = f.chLen(b + ret.siz, maxsiz - ret.siz);
+        }
+        catch(buffer_small &){
+            break;
+        }
+        if(chl > maxsiz - ret.siz)
+            break;
+        ret.siz += chl;
+        ret.len++;
+    }
+    return ret;
+}
+
 template<typename T, typename S>
 concept read_char_stream = general_enctype<S> &&  requires(T stream, const tchar_pt<S> dat, const size_t siz){
         {stream.char_read(dat, siz)}->std::convertible_to<uint>;
@@ -89,6 +122,32 @@ class CharIStream{
     protected:
         virtual uint do_char_read(tchar_pt<T>, size_t)=0;
         virtual uint do_ghost_read(tchar_pt<T>, size_t)=0;
+        /*
+         * Reads at most max_chars characters in siz bytes, streams should override it in order to copy
+         * them at once.
+         *
+         * Throws IOEOF or IOBufsmall only if no character has been read
+         */
+        virtual dimensions do_string_read(tchar_pt<T> pt, size_t siz, size_t max_chars){
+            dimensions ret{};
+            while(ret.len < max_chars){
+                try{
+                    ret.siz += do_char_read(tchar_pt<T>{pt.data() + ret.siz, pt.raw_format()}, siz - ret.siz);
+                    ret.len++;
+                }
+                catch(IOEOF &){
+                    if(ret.len == 0)
+                        throw;
+                    break;
+                }
+                catch(IOBufsmall &){
+                    if(ret.len == 0)
+                        throw;
+                    break;
+                }
+            }
+            return ret;
+        }
         virtual void do_close()=0;
         virtual EncMetric_info<T> do_encmetric() const noexcept=0;
     public:
@@ -123,6 +182,14 @@ class CharIStream{
                 throw IOIncomplete{"Not a valid character"};
             return ret;
         }
+        /*
+         * Reads more characters at once, returns the number of characters and bytes read
+         */
+        template<general_enctype S>
+        dimensions string_read(tchar_pt<S> pt, size_t buf, size_t max_chars = std::numeric_limits<size_t>::max()){
+            auto enc=do_encmetric();
+            return do_string_read(inv_rebase_pointer(pt, enc), buf, max_chars);
+        }
         void close() {return do_close();}
         EncMetric_info<T> raw_format() const noexcept{ return do_encmetric();}
         const EncMetric<typename T::ctype> *format() const noexcept{ return raw_format().format();}
@@ -134,6 +201,36 @@ class CharOStream{
         virtual uint do_char_write(const_tchar_pt<T>, size_t)=0;
 
         virtual size_t do_string_write(const adv_string_view<T> &str)=0;
+        /*
+         * Writes at most max_chars complete characters stored in siz bytes
+         *
+         * Throws IOBufsmall only if no character has been written
+         */
+        virtual dimensions do_chars_write(const_tchar_pt<T> pt, size_t siz, size_t max_chars){
+            dimensions ret{};
+            while(ret.len < max_chars && ret.siz < siz){
+                try{
+                    ret.siz += do_char_write(pt + ret.siz, siz - ret.siz);
+                    ret.len++;
+                }
+                catch(IOBufsmall &){
+                    if(ret.len == 0)
+                        throw;
+                    break;
+                }
+            }
+            return ret;
+        }
+        /*
+         * Writes n strings in order, streams can override it in order to send them with a single
+         * system call
+         */
+        virtual size_t do_write_vec(const adv_string_view<T> *strs, size_t n){
+            size_t ret = 0;
+            for(size_t i=0; i<n; i++)
+                ret += do_string_write(strs[i]);
+            return ret;
+        }
         virtual void do_close()=0;
         virtual void do_flush()=0;
         virtual EncMetric_info<T> do_encmetric() const noexcept=0;
@@ -153,6 +250,28 @@ class CharOStream{
 
         template<general_enctype S>
         size_t string_write(const adv_string_view<S> &str) {return do_string_write(str.rebase(do_encmetric()));}
+        /*
+         * Writes more characters at once, returns the number of characters and bytes written
+         */
+        template<general_enctype S>
+        dimensions chars_write(const_tchar_pt<S> pt, size_t buf, size_t max_chars = std::numeric_limits<size_t>::max()){
+            auto enc = do_encmetric();
+            return do_chars_write(rebase_pointer(pt, enc), buf, max_chars);
+        }
+        template<general_enctype S>
+        dimensions chars_write(tchar_pt<S> pt, size_t buf, size_t max_chars = std::numeric_limits<size_t>::max()){
+            return chars_write(pt.cast(), buf, max_chars);
+        }
+        size_t write_vec(std::span<const adv_string_view<T>> strs) {return do_write_vec(strs.data(), strs.size());}
+        /*
+         * Writes all the strings at once, for example print_all(header, payload, newline())
+         */
+        template<general_enctype... S> requires (sizeof...(S) > 0)
+        size_t print_all(const adv_string_view<S> &... strs){
+            auto enc = do_encmetric();
+            const adv_string_view<T> vs[] = {strs.rebase(enc)...};
+            return do_write_vec(vs, sizeof...(S));
+        }
         void close() {return do_close();}
         void flush() {return do_flush();}
         EncMetric_info<T> raw_format() const noexcept{ return do_encmetric();}
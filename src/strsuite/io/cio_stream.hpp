@@ -53,6 +53,11 @@ public:
 
     size_t read(byte *b, size_t siz) requires (fg == file_type::read){
         std::size_t ret = fread(b, 1, siz, file);
+        /*
+         * The last chunk is returned before signaling the end of file
+         */
+        if(ret > 0)
+            return ret;
         if(std::feof(file))
             throw IOEOF{};
         else if(std::ferror(file))
@@ -19,8 +19,10 @@
 #include <type_traits>
 #include <strsuite/encmetric/base.hpp>
 #include <strsuite/encmetric/byte_tools.hpp>
+#include <strsuite/encmetric/basic_ptr.hpp>
 #include <strsuite/io/buffers.hpp>
 #include <cstring>
+#include <span>
 
 namespace sts{
 
@@ -34,23 +36,175 @@ concept osyscall = requires(Sys s,  const byte *b, size_t t){
     {s.write_wrap(b, t)} -> std::same_as<size_t>;
 };
 
+/*
+ * Gathers more buffers in a single system call
+ */
+template<typename Sys>
+concept vsyscall = requires(Sys s, const std::span<const byte> *v, size_t n){
+    {s.writev_wrap(v, n)} -> std::same_as<size_t>;
+};
+
+/*
+ * System calls returning 0 have been interrupted and are repeated, but at most max_write_retries
+ * times in a row
+ */
+inline constexpr uint max_write_retries = 64;
+
+/*
+ * Writes all the bytes, throws IOFail if the system doesn't accept them
+ */
+template<osyscall Sys>
+void force_write(Sys &sy, const byte *b, size_t siz){
+    uint retry = 0;
+    while(siz > 0){
+        size_t wt = sy.write_wrap(b, siz);
+        if(wt == 0){
+            if(++retry == max_write_retries)
+                throw IOFail{"Unable to write data"};
+            continue;
+        }
+        retry = 0;
+        b += wt;
+        siz -= wt;
+    }
+}
+
+/*
+ * Writes n buffers entirely, with a single system call when Sys supports it.
+ *
+ * Written buffers are modified
+ */
+template<osyscall Sys>
+void force_gather_write(Sys &sy, std::span<const byte> *v, size_t n){
+    uint retry = 0;
+    while(n > 0){
+        if(v->size() == 0){
+            v++;
+            n--;
+            continue;
+        }
+        size_t wt;
+        if constexpr(vsyscall<Sys>)
+            wt = sy.writev_wrap(v, n);
+        else
+            wt = sy.write_wrap(v->data(), v->size());
+        if(wt == 0){
+            if(++retry == max_write_retries)
+                throw IOFail{"Unable to write data"};
+            continue;
+        }
+        retry = 0;
+        while(wt > 0){
+            if(wt >= v->size()){
+                wt -= v->size();
+                v++;
+                n--;
+            }
+            else{
+                *v = v->subspan(wt);
+                wt = 0;
+            }
+        }
+    }
+}
+
+/*
+ * Linear output buffer used by buffered output streams, system calls are made with the Sys object
+ * passed to each member function. Data bigger than the buffer skips it
+ */
+template<osyscall Sys>
+class buffered_sink{
+    private:
+        basic_ptr buffer;
+        size_t las;
+    public:
+        explicit buffered_sink(size_t siz, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) : buffer{siz, alloc}, las{0} {}
+
+        size_t capacity() const noexcept{ return buffer.dimension;}
+        size_t pending() const noexcept{ return las;}
+
+        void put(Sys &sy, const byte *b, size_t siz){
+            if(siz > buffer.dimension - las){
+                flush(sy);
+                if(siz >= buffer.dimension){
+                    force_write(sy, b, siz);
+                    return;
+                }
+            }
+            copy_bytes(buffer.memory + las, b, siz);
+            las += siz;
+        }
+        void flush(Sys &sy){
+            if(las > 0){
+                force_write(sy, buffer.memory, las);
+                las = 0;
+            }
+        }
+        /*
+         * Pending data is flushed before replacing the buffer
+         */
+        void resize(Sys &sy, size_t siz){
+            flush(sy);
+            if(siz != buffer.dimension)
+                buffer = basic_ptr{siz, buffer.get_allocator()};
+        }
+        /*
+         * Small groups of strings are buffered, bigger ones are sent with the pending data in a single
+         * gather operation. Returns true if the strings have been only buffered
+         */
+        template<typename Str>
+        bool write_vec(Sys &sy, const Str *strs, size_t n){
+            size_t tot = 0;
+            for(size_t i=0; i<n; i++)
+                tot += strs[i].size();
+            if(tot <= buffer.dimension - las){
+                for(size_t i=0; i<n; i++){
+                    copy_bytes(buffer.memory + las, strs[i].data(), strs[i].size());
+                    las += strs[i].size();
+                }
+                return true;
+            }
+            constexpr size_t group = 16;
+            std::span<const byte> v[group + 1];
+            size_t i = 0;
+            while(i < n){
+                size_t k = 0;
+                if(las > 0)
+                    v[k++] = std::span<const byte>{buffer.memory, las};
+                while(k <= group && i < n){
+                    v[k++] = std::span<const byte>{strs[i].data(), strs[i].size()};
+                    i++;
+                }
+                force_gather_write(sy, v, k);
+                las = 0;
+            }
+            return false;
+        }
+};
+
+/*
+ * Both buffers are circular, so data is copied only once between the system and the user buffers.
+ * Requests bigger than the whole buffer skip it when it's empty
+ */
 template<isyscall Sys, size_t bufsiz>
-class istr_buffer : private basic_buffer<istr_buffer<Sys, bufsiz>, true, false>{
+class istr_buffer : private ring_buffer<istr_buffer<Sys, bufsiz>, true, false>{
     private:
         Sys sy;
         byte buf[bufsiz];
 
-        void inc_siz(uint){
-
-            size_t wt = sy.read_wrap(this->base + this->las, this->rem);
+        void inc_siz(size_t){
+            size_t fc = this->free_chunk();
+            if(fc == 0)
+                return;
+            size_t wt = sy.read_wrap(this->base + this->las(), fc);
             if(wt > 0){
                 this->raw_las_step(wt);
             }
         }
 
     public:
-        istr_buffer(const Sys &f) : basic_buffer<istr_buffer<Sys, bufsiz>, true, false>{buf, bufsiz}, sy{f} {}
-        istr_buffer(Sys &&f) : basic_buffer<istr_buffer<Sys, bufsiz>, true, false>{buf, bufsiz}, sy{std::move(f)} {}
+        istr_buffer(const Sys &f) : ring_buffer<istr_buffer<Sys, bufsiz>, true, false>{buf, bufsiz}, sy{f} {}
+        istr_buffer(Sys &&f) : ring_buffer<istr_buffer<Sys, bufsiz>, true, false>{buf, bufsiz}, sy{std::move(f)} {}
 
         Sys get_system_id() const noexcept {return sy;}
 
@@ -59,68 +213,35 @@ class istr_buffer : private basic_buffer<istr_buffer<Sys, bufsiz>, true, false>{
         size_t read(byte *by, size_t stm){
             if(stm == 0)
                 return 0;
+            if(this->siz == 0 && stm >= bufsiz)
+                return sy.read_wrap(by, stm);
             size_t inc = this->ask_size(stm);
-            copy_bytes(by, this->base + this->fir, inc);
-            this->raw_fir_step(inc);
+            this->copy_out(by, inc);
             return inc;
         }
 
         void discard_buffer(){
             this->discard_all();
         }
-
-        friend class basic_buffer<istr_buffer<Sys, bufsiz>, true, false>;
-};
-
-template<osyscall Sys, size_t bufsiz>
-class ostr_buffer : private basic_buffer<ostr_buffer<Sys, bufsiz>, false, true>{
-    private:
-        Sys sy;
-        byte buf[bufsiz];
-
-        void inc_rem(size_t){
-            size_t wt;
-            bool repeat;
-            do{
-                repeat=false;
-                wt = sy.write_wrap(this->base + this->fir, this->siz);
-                if(wt > 0){
-                    this->raw_fir_step(wt);
-                }
-                else
-                    repeat=true;
-            }
-            while(repeat);
-            this->rewind();//increases rem by n
+        /*
+         * Buffered bytes stored contiguously, the others are at the beginning of the buffer.
+         * Use skip in order to consume them
+         */
+        std::span<const byte> chunk() const noexcept{
+            return std::span<const byte>{this->base + this->fir, this->data_chunk()};
         }
-
-    public:
-        ostr_buffer(const Sys &f) : basic_buffer<ostr_buffer<Sys, bufsiz>, false, true>{buf, bufsiz}, sy{f} {}
-        ostr_buffer(Sys &&f) : basic_buffer<ostr_buffer<Sys, bufsiz>, false, true>{buf, bufsiz}, sy{std::move(f)} {}
-
-        size_t write(const byte *by, size_t stm){
-            if(stm == 0)
-                return 0;
-            size_t mi = this->ask_rem(stm);
-            copy_bytes(this->base + this->las, by, mi);
-            this->raw_las_step(mi);
-            return mi;
+        void skip(size_t n) noexcept{
+            this->raw_fir_step(n);
         }
-
-        void flush(){
-            while(this->siz > 0){
-                size_t wt = sy.write_wrap(this->base + this->fir, this->siz);
-                if(wt > 0){
-                    this->raw_fir_step(wt);
-                }
-            }
-            this->discard_all();
+        /*
+         * True if a whole character can be read without calling the system
+         */
+        template<typename T>
+        bool has_char(EncMetric_info<T> f) const noexcept{
+            return this->buffered_chLen(f) > 0;
         }
 
-        Sys get_system_id() const noexcept {return sy;}
-        Sys &system_ref() noexcept {return sy;}
-
-        friend class basic_buffer<ostr_buffer<Sys, bufsiz>, false, true>;
+        friend class ring_buffer<istr_buffer<Sys, bufsiz>, true, false>;
 };
 
 }
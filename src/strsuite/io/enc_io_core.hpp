@@ -22,6 +22,7 @@
 #include <strsuite/io/enc_io_exc.hpp>
 #include <strsuite/io/enc_io_buffer.hpp>
 #include <strsuite/io/nl_stream.hpp>
+#include <strsuite/io/newline_scan.hpp>
 
 namespace sts{
 
@@ -37,7 +38,25 @@ protected:
 public:
     void discard(){do_discard();}
 };
-class OutputStream : public NewlineOStream<IOenc>{};
+/*
+ * Output buffering policies:
+ *  - unbuffered: data is written immediately;
+ *  - line: data is written when a newline is found or the buffer is full;
+ *  - full: data is written only when the buffer is full or flush() is called
+ */
+enum class buffer_mode {unbuffered, line, full};
+
+class OutputStream : public NewlineOStream<IOenc>{
+protected:
+    virtual void do_set_buffering(buffer_mode, size_t)=0;
+    virtual buffer_mode do_buffering() const noexcept=0;
+public:
+    /*
+     * Flushes all the buffered data and changes the policy, if bufsiz is 0 a default size is used
+     */
+    void set_buffering(buffer_mode m, size_t bufsiz = 0){ do_set_buffering(m, bufsiz);}
+    buffer_mode buffering() const noexcept{ return do_buffering();}
+};
 
 InputStream &get_console_stdin();
 OutputStream &get_console_stdout();
@@ -79,6 +98,67 @@ class Console_istream : public InputStream{
                 conv.get_char_bytes(buffer, false);
             return conv.ghost_read(pt, siz);
         }
+        /*
+         * Validated single character read through conv, used when the character isn't stored
+         * contiguously inside buffer
+         */
+        uint valid_char_read(tchar_pt<IOenc> pt, size_t siz){
+            if(conv.length() == 0)
+                conv.get_char_bytes(buffer, true);
+            return conv.char_read(pt, siz);
+        }
+        /*
+         * Moves all the characters already buffered, without waiting for new input.
+         *
+         * Runs of characters are validated directly inside buffer and copied once, a run stops
+         * at the first invalid or incomplete character
+         */
+        dimensions do_string_read(tchar_pt<IOenc> pt, size_t siz, size_t nchr){
+            EncMetric_info<IOenc> f{};
+            dimensions ret{};
+            if(nchr == 0)
+                return ret;
+            if(conv.length() > 0 || !buffer.has_char(f)){
+                ret.siz = valid_char_read(pt, siz);
+                ret.len = 1;
+            }
+            while(ret.len < nchr && ret.siz < siz){
+                std::span<const byte> chk = buffer.chunk();
+                size_t avail = siz - ret.siz;
+                size_t lim = chk.size() < avail ? chk.size() : avail;
+                dimensions run{};
+                while(ret.len + run.len < nchr && run.siz < lim){
+                    const byte *b = chk.data() + run.siz;
+                    uint chl;
+                    try{
+                        chl = f.chLen(b, lim - run.siz);
+                    }
+                    catch(...){
+                        break;
+                    }
+                    if(chl > lim - run.siz || !f.validChar(b, chl))
+                        break;
+                    run.siz += chl;
+                    run.len++;
+                }
+                if(run.len == 0){
+                    /*
+                     * Characters crossing the wrap point or not fitting in pt are left to the next call,
+                     * invalid ones are reported only if nothing has been read
+                     */
+                    if(ret.len > 0)
+                        break;
+                    ret.siz = valid_char_read(pt, siz);
+                    ret.len = 1;
+                    continue;
+                }
+                copy_bytes(pt.data() + ret.siz, chk.data(), run.siz);
+                buffer.skip(run.siz);
+                ret.len += run.len;
+                ret.siz += run.siz;
+            }
+            return ret;
+        }
 
         void do_close() {}
 
@@ -96,34 +176,116 @@ class Console_istream : public InputStream{
 template<typename Sys>
 class Console_ostream : public OutputStream{
     private:
-        ostr_buffer<Sys, 60> buffer;
-        string_stream<IOenc> conv;
+        Sys sy;
+        buffered_sink<Sys> sink;
+        buffer_mode mode;
+
+        static size_t buffer_size(buffer_mode m, size_t bufsiz) noexcept{
+            if(bufsiz >= 16)
+                return bufsiz;
+            return m == buffer_mode::full ? block_buffer : line_buffer;
+        }
+        /*
+         * Terminals are line buffered, pipes and files are fully buffered
+         */
+        static buffer_mode default_mode(const Sys &s) noexcept{
+            if constexpr(requires{ {s.is_terminal()} -> std::convertible_to<bool>; })
+                return s.is_terminal() ? buffer_mode::line : buffer_mode::full;
+            else
+                return buffer_mode::line;
+        }
+
+        /*
+         * Applies the buffering policy to just written data
+         */
+        void written(const byte *b, size_t siz){
+            if(mode == buffer_mode::unbuffered)
+                do_flush();
+            else if(mode == buffer_mode::line){
+                adv_string_view<IOenc> nl = sy.do_newline();
+                if(find_newline(b, siz, nl.data(), nl.size(), EncMetric_info<IOenc>{}.min_bytes()) != siz)
+                    do_flush();
+            }
+        }
     protected:
-        adv_string_view<IOenc> do_newline() const noexcept{ return buffer.get_system_id().do_newline();}
+        adv_string_view<IOenc> do_newline() const noexcept{ return sy.do_newline();}
         uint do_char_write(const_tchar_pt<IOenc> pt, size_t siz){
-            uint ret = conv.char_write(pt, siz);
-            while(conv.length() > 0)
-                conv.put_char_bytes(buffer);
-            return ret;
+            uint chl;
+            try{
+                chl = pt.chLen(siz);
+            }
+            catch(buffer_small &e){
+                throw IOBufsmall{e};
+            }
+            if(chl > siz)
+                throw IOBufsmall{chl - static_cast<uint>(siz)};
+            sink.put(sy, pt.data(), chl);
+            written(pt.data(), chl);
+            return chl;
         }
+        /*
+         * Strings are already in the system encoding, so they're copied directly from the view
+         */
         size_t do_string_write(const adv_string_view<IOenc> &str){
-            size_t ret = conv.string_write(str);
-            conv.put_all_char_bytes(buffer);
+            sink.put(sy, str.data(), str.size());
+            written(str.data(), str.size());
+            return str.size();
+        }
+        dimensions do_chars_write(const_tchar_pt<IOenc> pt, size_t siz, size_t nchr){
+            dimensions ret = measure_chars(pt.raw_format(), pt.data(), siz, nchr);
+            if(ret.len == 0){
+                if(nchr == 0 || siz == 0)
+                    return ret;
+                ret.siz = do_char_write(pt, siz);
+                ret.len = 1;
+                return ret;
+            }
+            sink.put(sy, pt.data(), ret.siz);
+            written(pt.data(), ret.siz);
             return ret;
         }
+        /*
+         * The buffering policy is applied only if the strings have been buffered
+         */
+        size_t do_write_vec(const adv_string_view<IOenc> *strs, size_t n){
+            size_t tot = 0;
+            for(size_t i=0; i<n; i++)
+                tot += strs[i].size();
+            if(sink.write_vec(sy, strs, n)){
+                for(size_t i=0; i<n && sink.pending() > 0; i++)
+                    written(strs[i].data(), strs[i].size());
+            }
+            return tot;
+        }
+        /*
+         * The newline is flushed only by line buffered and unbuffered streams
+         */
+        size_t do_endl(){ return do_putnl();}
 
         void do_close() {}
 
-        void do_flush(){
-            conv.put_all_char_bytes(buffer);
-            buffer.flush();
+        void do_flush(){ sink.flush(sy);}
+
+        void do_set_buffering(buffer_mode m, size_t bufsiz){
+            sink.resize(sy, buffer_size(m, bufsiz));
+            mode = m;
         }
+        buffer_mode do_buffering() const noexcept{ return mode;}
 
         EncMetric_info<IOenc> do_encmetric() const noexcept{ return EncMetric_info<IOenc>{};}
     public:
-        Console_ostream (const Sys &s) : buffer{s} {}
-};
+        static constexpr size_t line_buffer = 1024;
+        static constexpr size_t block_buffer = 1 << 16;
 
+        Console_ostream(const Sys &s) : Console_ostream{s, default_mode(s)} {}
+        Console_ostream(const Sys &s, buffer_mode m, size_t bufsiz = 0) : sy{s}, sink{buffer_size(m, bufsiz)}, mode{m} {}
+        ~Console_ostream(){
+            try{
+                do_flush();
+            }
+            catch(...){}
+        }
+};
 
 }
 
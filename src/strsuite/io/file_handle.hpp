@@ -0,0 +1,65 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdint>
+#include <span>
+#include <strsuite/io/cio_stream.hpp>
+
+namespace sts{
+
+/*
+ * Owns a system file descriptor (a HANDLE on Windows).
+ *
+ * read_wrap and write_wrap follow the same rules of console syscalls: they return 0 if they've been
+ * interrupted and must be called again, read_wrap throws IOEOF at the end of the file
+ */
+class file_handle{
+    private:
+        std::intptr_t handle;
+
+        static std::intptr_t open_file(const char *, file_type);
+        void close_file() noexcept;
+    public:
+        /*
+         * Throws IOFail if the file cannot be opened
+         */
+        file_handle(const char *fname, file_type mode) : handle{open_file(fname, mode)} {}
+        file_handle(const file_handle &) = delete;
+        file_handle(file_handle &&f) noexcept : handle{f.handle} {
+            f.handle = -1;
+        }
+        ~file_handle(){ close_file();}
+        file_handle &operator=(const file_handle &) = delete;
+        file_handle &operator=(file_handle &&f) noexcept{
+            if(this != &f){
+                close_file();
+                handle = f.handle;
+                f.handle = -1;
+            }
+            return *this;
+        }
+
+        bool is_open() const noexcept{ return handle != -1;}
+        void close() noexcept{ close_file();}
+
+        size_t read_wrap(byte *, size_t);
+        size_t write_wrap(const byte *, size_t);
+        size_t writev_wrap(const std::span<const byte> *, size_t);
+};
+
+}
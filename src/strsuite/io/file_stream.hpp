@@ -0,0 +1,116 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/io/nl_stream.hpp>
+#include <strsuite/io/file_handle.hpp>
+#include <strsuite/io/enc_io_buffer.hpp>
+#include <strsuite/io/newline_scan.hpp>
+
+namespace sts{
+
+/*
+ * Encoded file streams with a buffer of configurable size.
+ *
+ * Lines and strings are read/written in blocks, so they don't need a virtual call for each character
+ */
+template<general_enctype T>
+class FileIStream : public NewlineIStream<T>{
+    private:
+        file_handle fh;
+        EncMetric_info<T> format;
+        basic_ptr buffer;
+        basic_ptr nl;
+        size_t fir, las;
+        bool ended;
+
+        /*
+         * Reads until at least need bytes are available, returns false if the file ended before
+         */
+        bool fill(size_t need);
+        uint next_chLen();
+        /*
+         * Offset of the first newline from fir, las - fir if not found
+         */
+        size_t find_newline() const noexcept;
+        adv_string<T> read_line(std::pmr::memory_resource *, bool);
+    protected:
+        adv_string_view<T> do_newline() const noexcept{ return direct_build(const_tchar_pt<T>{nl.memory, format}, 1, nl.dimension);}
+        uint do_char_read(tchar_pt<T>, size_t);
+        uint do_ghost_read(tchar_pt<T>, size_t);
+        dimensions do_string_read(tchar_pt<T>, size_t, size_t);
+        adv_string<T> do_getline(std::pmr::memory_resource *all){ return read_line(all, true);}
+        adv_string<T> do_get_line(std::pmr::memory_resource *all){ return read_line(all, false);}
+        void do_close(){ fh.close();}
+        EncMetric_info<T> do_encmetric() const noexcept{ return format;}
+    public:
+        static constexpr size_t default_buffer = 1 << 16;
+
+        FileIStream(const char *fname, EncMetric_info<T>, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        explicit FileIStream(const char *fname, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>
+            : FileIStream{fname, EncMetric_info<T>{}, bufsiz, alloc} {}
+        FileIStream(const char *fname, const EncMetric<typename T::ctype> *f, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires widenc<T>
+            : FileIStream{fname, EncMetric_info<T>{f}, bufsiz, alloc} {}
+
+        bool eof() const noexcept{ return ended && fir == las;}
+        size_t buffer_size() const noexcept{ return buffer.dimension;}
+};
+
+template<general_enctype T>
+class FileOStream : public NewlineOStream<T>{
+    private:
+        file_handle fh;
+        EncMetric_info<T> format;
+        buffered_sink<file_handle> sink;
+        basic_ptr nl;
+    protected:
+        adv_string_view<T> do_newline() const noexcept{ return direct_build(const_tchar_pt<T>{nl.memory, format}, 1, nl.dimension);}
+        uint do_char_write(const_tchar_pt<T>, size_t);
+        dimensions do_chars_write(const_tchar_pt<T>, size_t, size_t);
+        size_t do_write_vec(const adv_string_view<T> *, size_t);
+        /*
+         * Strings bigger than the buffer are written directly to the file
+         */
+        size_t do_string_write(const adv_string_view<T> &str){
+            sink.put(fh, str.data(), str.size());
+            return str.size();
+        }
+        void do_flush();
+        void do_close(){
+            do_flush();
+            fh.close();
+        }
+        EncMetric_info<T> do_encmetric() const noexcept{ return format;}
+    public:
+        static constexpr size_t default_buffer = 1 << 16;
+
+        FileOStream(const char *fname, EncMetric_info<T>, bool append = false, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        explicit FileOStream(const char *fname, bool append = false, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>
+            : FileOStream{fname, EncMetric_info<T>{}, append, bufsiz, alloc} {}
+        FileOStream(const char *fname, const EncMetric<typename T::ctype> *f, bool append = false, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires widenc<T>
+            : FileOStream{fname, EncMetric_info<T>{f}, append, bufsiz, alloc} {}
+        /*
+         * Buffered data is written, errors are ignored: call flush() before destroying the stream
+         * in order to detect them
+         */
+        ~FileOStream();
+
+        size_t buffer_size() const noexcept{ return sink.capacity();}
+};
+
+#include <strsuite/io/file_stream.tpp>
+}
@@ -0,0 +1,208 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Encodes '\n', buffers must be able to contain at least a character
+ */
+template<general_enctype T>
+basic_ptr file_stream_newline(EncMetric_info<T> f, std::pmr::memory_resource *alloc){
+    byte tmp[16];
+    uint nls = f.encode('\n'_uni, tmp, 16);
+    return basic_ptr{tmp, nls, alloc};
+}
+
+inline size_t file_stream_bufsiz(size_t bufsiz){
+    return bufsiz < 16 ? 16 : bufsiz;
+}
+
+template<general_enctype T>
+FileIStream<T>::FileIStream(const char *fname, EncMetric_info<T> f, size_t bufsiz, std::pmr::memory_resource *alloc)
+    : fh{fname, file_type::read}, format{f}, buffer{file_stream_bufsiz(bufsiz), alloc}, nl{file_stream_newline(f, alloc)}, fir{0}, las{0}, ended{false} {}
+
+template<general_enctype T>
+bool FileIStream<T>::fill(size_t need){
+    if(las - fir >= need)
+        return true;
+    if(fir > 0){
+        move_bytes(buffer.memory, buffer.memory + fir, las - fir);
+        las -= fir;
+        fir = 0;
+    }
+    if(need > buffer.dimension)
+        buffer.exp_fit(need);
+    while(las < need && !ended){
+        try{
+            las += fh.read_wrap(buffer.memory + las, buffer.dimension - las);
+        }
+        catch(IOEOF &){
+            ended = true;
+        }
+    }
+    return las >= need;
+}
+
+template<general_enctype T>
+uint FileIStream<T>::next_chLen(){
+    if(!fill(format.min_bytes())){
+        if(fir == las)
+            throw IOEOF{};
+        throw IOIncomplete{};
+    }
+    uint chl = 0;
+    bool found = false;
+    while(!found){
+        try{
+            chl = format.chLen(buffer.memory + fir, las - fir);
+            found = true;
+        }
+        catch(buffer_small &e){
+            if(!fill(las - fir + e.get_required_size()))
+                throw IOIncomplete{};
+        }
+    }
+    if(!fill(chl))
+        throw IOIncomplete{};
+    return chl;
+}
+
+template<general_enctype T>
+uint FileIStream<T>::do_char_read(tchar_pt<T> pt, size_t siz){
+    uint chl = do_ghost_read(pt, siz);
+    fir += chl;
+    return chl;
+}
+
+template<general_enctype T>
+uint FileIStream<T>::do_ghost_read(tchar_pt<T> pt, size_t siz){
+    uint chl = next_chLen();
+    if(siz < chl)
+        throw IOBufsmall{chl - siz};
+    copy_bytes(pt.data(), buffer.memory + fir, chl);
+    return chl;
+}
+
+template<general_enctype T>
+dimensions FileIStream<T>::do_string_read(tchar_pt<T> pt, size_t siz, size_t nchr){
+    fill(format.min_bytes());
+    dimensions ret = measure_chars(format, buffer.memory + fir, siz < las - fir ? siz : las - fir, nchr);
+    if(ret.len == 0){
+        /*
+         * Incomplete character or too small destination
+         */
+        if(nchr == 0)
+            return ret;
+        ret.siz = do_char_read(pt, siz);
+        ret.len = 1;
+        return ret;
+    }
+    copy_bytes(pt.data(), buffer.memory + fir, ret.siz);
+    fir += ret.siz;
+    return ret;
+}
+
+template<general_enctype T>
+size_t FileIStream<T>::find_newline() const noexcept{
+    return sts::find_newline(buffer.memory + fir, las - fir, nl.memory, nl.dimension, format.min_bytes());
+}
+
+template<general_enctype T>
+adv_string<T> FileIStream<T>::read_line(std::pmr::memory_resource *all, bool keep_nl){
+    string_stream<T> stream{format, all};
+    fill(1);
+    while(true){
+        size_t avail = las - fir;
+        size_t off = find_newline();
+        if(off < avail){
+            size_t lsiz = keep_nl ? off + nl.dimension : off;
+            stream.string_write(adv_string_view<T>{const_tchar_pt<T>{buffer.memory + fir, format}, lsiz});
+            fir += off + nl.dimension;
+            break;
+        }
+        if(ended){
+            if(avail > 0)
+                stream.string_write(adv_string_view<T>{const_tchar_pt<T>{buffer.memory + fir, format}, avail});
+            fir = las;
+            break;
+        }
+        /*
+         * The last bytes could be the beginning of a newline or of a character
+         */
+        size_t keep = avail < nl.dimension ? avail : nl.dimension - 1;
+        adv_string_view<T> part{const_tchar_pt<T>{buffer.memory + fir, format}, avail - keep};
+        stream.string_write(part);
+        fir += part.size();
+        fill(las - fir + 1);
+    }
+    return stream.move();
+}
+
+template<general_enctype T>
+FileOStream<T>::FileOStream(const char *fname, EncMetric_info<T> f, bool append, size_t bufsiz, std::pmr::memory_resource *alloc)
+    : fh{fname, append ? file_type::write_append : file_type::write_trunc}, format{f}, sink{file_stream_bufsiz(bufsiz), alloc}, nl{file_stream_newline(f, alloc)} {}
+
+template<general_enctype T>
+FileOStream<T>::~FileOStream(){
+    try{
+        do_flush();
+    }
+    catch(...){}
+}
+
+template<general_enctype T>
+uint FileOStream<T>::do_char_write(const_tchar_pt<T> pt, size_t siz){
+    uint chl;
+    try{
+        chl = format.chLen(pt.data(), siz);
+    }
+    catch(buffer_small &e){
+        throw IOBufsmall{e};
+    }
+    if(chl > siz)
+        throw IOBufsmall{chl - siz};
+    sink.put(fh, pt.data(), chl);
+    return chl;
+}
+
+template<general_enctype T>
+dimensions FileOStream<T>::do_chars_write(const_tchar_pt<T> pt, size_t siz, size_t nchr){
+    dimensions ret = measure_chars(format, pt.data(), siz, nchr);
+    if(ret.len == 0){
+        if(nchr == 0 || siz == 0)
+            return ret;
+        ret.siz = do_char_write(pt, siz);
+        ret.len = 1;
+        return ret;
+    }
+    sink.put(fh, pt.data(), ret.siz);
+    return ret;
+}
+
+template<general_enctype T>
+size_t FileOStream<T>::do_write_vec(const adv_string_view<T> *strs, size_t n){
+    size_t tot = 0;
+    for(size_t i=0; i<n; i++)
+        tot += strs[i].size();
+    sink.write_vec(fh, strs, n);
+    return tot;
+}
+
+template<general_enctype T>
+void FileOStream<T>::do_flush(){
+    if(fh.is_open())
+        sink.flush(fh);
+}
@@ -0,0 +1,110 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstring>
+#include <type_traits>
+#include <strsuite/encmetric/basic_ptr.hpp>
+#include <strsuite/encmetric/enc_string.hpp>
+#include <strsuite/io/char_stream.hpp>
+#include <strsuite/io/newline_scan.hpp>
+
+namespace sts{
+
+/*
+ * Reads lines from a byte stream without allocating a new string for each of them.
+ *
+ * Data is read in big blocks inside an internal buffer and scanned for the newline byte sequence,
+ * lines are returned as views of this buffer so they're valid only until the next call.
+ * The buffer grows only when a single line doesn't fit in it.
+ *
+ * If max_line is not zero longer lines are splitted in lines of at most max_line bytes,
+ * in this case truncated() returns true. With newline_mode::any "\n", "\r\n" and "\r" are all newlines
+ */
+template<general_enctype T, read_byte_stream IBStream>
+class line_reader{
+    private:
+        IBStream &stream;
+        EncMetric_info<T> format;
+        basic_ptr buffer;
+        basic_ptr nl, cr;
+        size_t fir, las, scanned;
+        size_t max_line;
+        size_t nlen;
+        newline_mode mode;
+        bool ended, trunc;
+
+        line_reader(IBStream &, EncMetric_info<T>, size_t, size_t, std::pmr::memory_resource *);
+        void fill();
+        /*
+         * Returns the offset of the newline from fir (and sets nlen) or las - fir if not found
+         */
+        size_t find_newline();
+        adv_string_view<T> build(size_t maxsiz) const{
+            return adv_string_view<T>{const_tchar_pt<T>{buffer.memory + fir, format}, maxsiz};
+        }
+    public:
+        line_reader(IBStream &, const adv_string_view<T> &newline, size_t bufsiz = 4096, size_t max_line = 0, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        /*
+         * Uses '\n' as newline
+         */
+        explicit line_reader(IBStream &, size_t bufsiz = 4096, size_t max_line = 0, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>;
+        line_reader(IBStream &, newline_mode, size_t bufsiz = 4096, size_t max_line = 0, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<T>;
+        line_reader(const line_reader &) = delete;
+        line_reader &operator=(const line_reader &) = delete;
+
+        /*
+         * Next line without newline, returns false when there are no more lines.
+         *
+         * Throws IOIncomplete if the stream ends inside a character
+         */
+        conditional_result<adv_string_view<T>> next();
+        bool truncated() const noexcept{ return trunc;}
+        bool eof() const noexcept{ return ended && fir == las;}
+        size_t buffer_size() const noexcept{ return buffer.dimension;}
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+};
+
+/*
+ * Calls f for each line, if f returns a bool then false stops the reading.
+ * Returns the number of processed lines
+ */
+template<general_enctype T, read_byte_stream IBStream, typename F>
+size_t for_each_line(line_reader<T, IBStream> &reader, F &&f){
+    size_t ret = 0;
+    while(true){
+        conditional_result<adv_string_view<T>> line = reader.next();
+        if(!line)
+            return ret;
+        ret++;
+        if constexpr(std::is_same_v<std::invoke_result_t<F &, const adv_string_view<T> &>, bool>){
+            if(!f(line.data))
+                return ret;
+        }
+        else
+            f(line.data);
+    }
+}
+
+template<strong_enctype T, read_byte_stream IBStream, typename F>
+size_t for_each_line(IBStream &stream, F &&f, size_t bufsiz = 4096, size_t max_line = 0){
+    line_reader<T, IBStream> reader{stream, bufsiz, max_line};
+    return for_each_line(reader, std::forward<F>(f));
+}
+
+#include <strsuite/io/line_reader.tpp>
+}
@@ -0,0 +1,142 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T, read_byte_stream IBStream>
+line_reader<T, IBStream>::line_reader(IBStream &s, EncMetric_info<T> f, size_t bufsiz, size_t maxl, std::pmr::memory_resource *alloc) : stream{s}, format{f}, buffer{bufsiz == 0 ? 4096 : bufsiz, alloc}, nl{alloc}, cr{alloc}, fir{0}, las{0}, scanned{0}, max_line{maxl}, nlen{0}, mode{newline_mode::exact}, ended{false}, trunc{false} {}
+
+template<general_enctype T, read_byte_stream IBStream>
+line_reader<T, IBStream>::line_reader(IBStream &s, const adv_string_view<T> &newline, size_t bufsiz, size_t maxl, std::pmr::memory_resource *alloc) : line_reader{s, newline.raw_format(), bufsiz, maxl, alloc} {
+    if(newline.size() == 0)
+        throw InvalidOP{};
+    nl = basic_ptr{newline.data(), newline.size(), alloc};
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+line_reader<T, IBStream>::line_reader(IBStream &s, size_t bufsiz, size_t maxl, std::pmr::memory_resource *alloc) requires strong_enctype<T> : line_reader{s, EncMetric_info<T>{}, bufsiz, maxl, alloc} {
+    byte tmp[16];
+    uint nls = format.encode('\n'_uni, tmp, 16);
+    nl = basic_ptr{tmp, nls, alloc};
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+line_reader<T, IBStream>::line_reader(IBStream &s, newline_mode m, size_t bufsiz, size_t maxl, std::pmr::memory_resource *alloc) requires strong_enctype<T> : line_reader{s, bufsiz, maxl, alloc} {
+    if(m == newline_mode::any){
+        byte tmp[16];
+        uint crs = format.encode('\r'_uni, tmp, 16);
+        if(crs != nl.dimension)
+            throw InvalidOP{};
+        cr = basic_ptr{tmp, crs, alloc};
+        mode = m;
+    }
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+void line_reader<T, IBStream>::fill(){
+    /*
+     * Only the incomplete line is moved
+     */
+    if(fir > 0){
+        move_bytes(buffer.memory, buffer.memory + fir, las - fir);
+        las -= fir;
+        fir = 0;
+    }
+    if(las == buffer.dimension)
+        buffer.exp_fit(buffer.dimension + 1);
+    try{
+        las += stream.read(buffer.memory + las, buffer.dimension - las);
+    }
+    catch(IOEOF &){
+        ended = true;
+    }
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+size_t line_reader<T, IBStream>::find_newline(){
+    const size_t avail = las - fir;
+    const size_t unit = format.min_bytes();
+    const byte *start = buffer.memory + fir + scanned;
+    if(mode == newline_mode::any){
+        newline_match m = find_any_newline(start, avail - scanned, nl.memory, cr.memory, unit);
+        if(m.off < avail - scanned){
+            /*
+             * A final "\r" is a newline only at the end of the stream
+             */
+            if(m.len == 0 && ended)
+                m.len = unit;
+            if(m.len > 0){
+                nlen = m.len;
+                return scanned + m.off;
+            }
+            scanned += m.off;
+        }
+        else
+            scanned = avail - (avail - scanned) % unit;
+        return avail;
+    }
+    const size_t nls = nl.dimension;
+    size_t off = sts::find_newline(start, avail - scanned, nl.memory, nls, unit);
+    if(off < avail - scanned){
+        nlen = nls;
+        return scanned + off;
+    }
+    /*
+     * Newlines must start at a character unit boundary, next scan starts from the first
+     * position that could still contain a newline
+     */
+    if(avail >= nls)
+        scanned = ((avail - nls) / unit + 1) * unit;
+    return avail;
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+auto line_reader<T, IBStream>::next() -> conditional_result<adv_string_view<T>>{
+    trunc = false;
+    while(true){
+        size_t avail = las - fir;
+        size_t off = find_newline();
+        bool found = off < avail;
+        if(max_line > 0 && (found ? off : avail) > max_line){
+            adv_string_view<T> ret = build(max_line);
+            if(ret.size() == 0)
+                ret = build(found ? off : avail);
+            if(ret.size() > 0){
+                fir += ret.size();
+                scanned = 0;
+                trunc = true;
+                return conditional_result<adv_string_view<T>>{true, ret};
+            }
+        }
+        if(found){
+            adv_string_view<T> ret = build(off);
+            fir += off + nlen;
+            scanned = 0;
+            return conditional_result<adv_string_view<T>>{true, ret};
+        }
+        if(ended){
+            if(avail == 0)
+                return conditional_result<adv_string_view<T>>{false, adv_string_view<T>{format}};
+            adv_string_view<T> ret = build(avail);
+            if(ret.size() < avail)
+                throw IOIncomplete{};
+            fir = las;
+            scanned = 0;
+            return conditional_result<adv_string_view<T>>{true, ret};
+        }
+        fill();
+    }
+}
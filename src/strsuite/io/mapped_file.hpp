@@ -0,0 +1,131 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/enc_c.hpp>
+#include <strsuite/io/enc_io_exc.hpp>
+
+namespace sts{
+
+/*
+ * Expected access pattern of a mapped file
+ */
+enum class map_advice {normal, sequential, random, willneed};
+
+/*
+ * Read-only memory mapped file, its content can be accessed as a string view without copying it.
+ *
+ * If the file starts with a BOM its encoding is detected and the BOM is excluded from the views
+ */
+class mapped_file{
+    private:
+        byte *base;
+        size_t blen;
+        const byte *mem;
+        size_t msiz;
+        size_t bom;
+        const EncMetric<unicode> *enc;
+
+        void map(const char *, bool);
+        void unmap() noexcept;
+        void detect() noexcept{
+            try{
+                enc = detect_bom(direct_build(const_tchar_pt<RAW<unicode>>{mem}, msiz, msiz));
+                bom = enc == DynEncoding<UTF8>::instance() ? 3 : 2;
+            }
+            catch(encoding_error &){
+                enc = nullptr;
+                bom = 0;
+            }
+        }
+        void reset() noexcept{
+            base = nullptr;
+            blen = 0;
+            mem = nullptr;
+            msiz = 0;
+            bom = 0;
+            enc = nullptr;
+        }
+    public:
+        /*
+         * If huge_pages is true the mapping is aligned to huge pages and the system is asked to use them,
+         * when supported. Throws IOFail if the file cannot be mapped
+         */
+        explicit mapped_file(const char *fname, bool huge_pages = false) : base{nullptr}, blen{0}, mem{nullptr}, msiz{0}, bom{0}, enc{nullptr} {
+            map(fname, huge_pages);
+            detect();
+        }
+        mapped_file(const mapped_file &) = delete;
+        mapped_file(mapped_file &&m) noexcept : base{m.base}, blen{m.blen}, mem{m.mem}, msiz{m.msiz}, bom{m.bom}, enc{m.enc} {
+            m.reset();
+        }
+        ~mapped_file(){ unmap();}
+        mapped_file &operator=(const mapped_file &) = delete;
+        mapped_file &operator=(mapped_file &&m) noexcept{
+            if(this != &m){
+                unmap();
+                base = m.base;
+                blen = m.blen;
+                mem = m.mem;
+                msiz = m.msiz;
+                bom = m.bom;
+                enc = m.enc;
+                m.reset();
+            }
+            return *this;
+        }
+
+        /*
+         * Whole file, BOM included
+         */
+        const byte *data() const noexcept{ return mem;}
+        size_t size() const noexcept{ return msiz;}
+        /*
+         * Encoding detected from the BOM, nullptr if the file doesn't start with a BOM
+         */
+        const EncMetric<unicode> *detected_format() const noexcept{ return enc;}
+        size_t bom_size() const noexcept{ return bom;}
+
+        /*
+         * Hints for the kernel about the range [off, off + len), ignored if not supported
+         */
+        void advise(map_advice, size_t off, size_t len);
+        void advise(map_advice a){ advise(a, 0, msiz);}
+
+        /*
+         * File content after the BOM, an incomplete last character is excluded
+         */
+        template<general_enctype T>
+        adv_string_view<T> view(EncMetric_info<T> f) const{
+            return adv_string_view<T>{const_tchar_pt<T>{mem + bom, f}, msiz - bom};
+        }
+        template<strong_enctype T>
+        adv_string_view<T> view() const{ return view(EncMetric_info<T>{});}
+        /*
+         * Uses the detected encoding, or fallback if the file hasn't a BOM.
+         *
+         * Throws encoding_error if both of them are missing
+         */
+        wstr_view wview(const EncMetric<unicode> *fallback = nullptr) const{
+            const EncMetric<unicode> *f = enc != nullptr ? enc : fallback;
+            if(f == nullptr)
+                throw encoding_error{"No BOM"};
+            return view(EncMetric_info<WIDE<unicode>>{f});
+        }
+};
+
+}
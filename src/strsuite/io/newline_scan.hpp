@@ -0,0 +1,48 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/byte_tools.hpp>
+
+namespace sts{
+
+/*
+ * Newline sequences accepted by line splitting functions:
+ *  - exact: only the newline of the stream;
+ *  - any: "\n", "\r\n" and "\r".
+ */
+enum class newline_mode {exact, any};
+
+struct newline_match{
+    size_t off, len;
+};
+
+/*
+ * Offset of the first nl inside b starting at a multiple of unit bytes, siz if there isn't any.
+ *
+ * Buffers are scanned with memchr for single byte units and with SSE2 (when available) for two bytes units
+ */
+size_t find_newline(const byte *b, size_t siz, const byte *nl, size_t nls, size_t unit) noexcept;
+
+/*
+ * First "\n", "\r\n" or "\r" where lf and cr are respectively '\n' and '\r' encoded in unit bytes.
+ * If the buffer ends with "\r" the newline could continue in the next buffer, in this case len is 0.
+ * If there isn't any newline off is siz
+ */
+newline_match find_any_newline(const byte *b, size_t siz, const byte *lf, const byte *cr, size_t unit) noexcept;
+
+}
@@ -46,15 +46,20 @@ class NewlineOStream : public CharOStream<T>{
         virtual adv_string_view<T> do_newline() const noexcept=0;
         virtual index_result do_is_endl(const byte *b, size_t siz)const noexcept;
         virtual size_t do_putnl();
+        /*
+         * Writes a newline and flushes the stream, buffered streams can override it in order to apply
+         * their own flushing policy
+         */
+        virtual size_t do_endl(){
+            size_t ret = do_putnl();
+            this->do_flush();
+            return ret;
+        }
     public:
         adv_string_view<T> newline() const noexcept{return do_newline();}
         index_result is_endl(const byte *b, size_t siz)const noexcept{ return do_is_endl(b, siz);}
         size_t putNL(){ return do_putnl();}
-        size_t endl(){
-            auto ret = this->do_putnl();
-            this->do_flush();
-            return ret;
-        }
+        size_t endl(){ return do_endl();}
         template<general_enctype S>
         size_t print(const adv_string_view<S> &str){
             return this->string_write(str);
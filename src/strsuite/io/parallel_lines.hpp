@@ -0,0 +1,87 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <strsuite/encmetric/enc_string.hpp>
+#include <strsuite/io/enc_io_exc.hpp>
+#include <strsuite/io/newline_scan.hpp>
+#include <strsuite/io/mapped_file.hpp>
+
+namespace sts{
+
+/*
+ * ordered: results are returned in the same order of lines;
+ * unordered: results of each chunk are appended as soon as the chunk ends.
+ */
+enum class merge_order {ordered, unordered};
+
+struct byte_range{
+    size_t fir, las;
+};
+
+/*
+ * Splits [b, b + siz) in at most nchunks ranges, each one ending just after a newline nl (or at siz).
+ * Boundaries are searched at multiples of head bytes: since the encoding has the opt_head property
+ * the newline found is always a whole character
+ */
+std::vector<byte_range> split_at_newlines(const byte *b, size_t siz, const byte *nl, size_t nls, size_t head, size_t nchunks);
+
+/*
+ * Number of threads used when nthreads is 0
+ */
+size_t pool_size(size_t nthreads) noexcept;
+
+/*
+ * Calls task(i) for each i in [0, ntasks) on nthreads threads (hardware_concurrency if 0).
+ * The first exception thrown is rethrown after all threads have ended
+ */
+void parallel_run(size_t ntasks, size_t nthreads, const std::function<void(size_t)> &task);
+
+/*
+ * Calls f for each line (without newline) of the text on a pool of threads, returns the number of lines.
+ * f must be callable concurrently from more threads.
+ *
+ * Encodings without opt_head property are processed by a single thread
+ */
+template<general_enctype T, typename F>
+size_t parallel_for_each_line(const adv_string_view<T> &str, F &&f, size_t nthreads = 0, newline_mode mode = newline_mode::exact);
+
+/*
+ * Collects the results of f for each line
+ */
+template<general_enctype T, typename F>
+auto parallel_map_lines(const adv_string_view<T> &str, F &&f, merge_order order = merge_order::ordered, size_t nthreads = 0, newline_mode mode = newline_mode::exact)
+    -> std::vector<std::invoke_result_t<F &, const adv_string_view<T> &>>;
+
+/*
+ * Content of mapped files is not scanned before splitting it
+ */
+template<strong_enctype T, typename F>
+size_t parallel_for_each_line(const mapped_file &file, F &&f, size_t nthreads = 0, newline_mode mode = newline_mode::exact);
+
+template<strong_enctype T, typename F>
+auto parallel_map_lines(const mapped_file &file, F &&f, merge_order order = merge_order::ordered, size_t nthreads = 0, newline_mode mode = newline_mode::exact)
+    -> std::vector<std::invoke_result_t<F &, const adv_string_view<T> &>>;
+
+#include <strsuite/io/parallel_lines.tpp>
+}
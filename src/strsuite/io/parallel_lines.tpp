@@ -0,0 +1,144 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * '\n' and '\r' encoded with T
+ */
+template<general_enctype T>
+struct line_separators{
+    byte lf[16], cr[16];
+    uint lfs, crs;
+
+    line_separators(EncMetric_info<T> f, newline_mode mode) : lf{}, cr{}, lfs{f.encode('\n'_uni, lf, 16)}, crs{f.encode('\r'_uni, cr, 16)} {
+        if(mode == newline_mode::any && lfs != crs)
+            throw InvalidOP{};
+    }
+};
+
+template<general_enctype T, typename F>
+void for_each_line_in(const byte *b, size_t siz, EncMetric_info<T> format, const line_separators<T> &sep, newline_mode mode, F &&f){
+    const size_t unit = format.min_bytes();
+    while(siz > 0){
+        size_t off, nlen;
+        if(mode == newline_mode::any){
+            /*
+             * Chunks end with '\n', so a final '\r' is at the end of the text
+             */
+            newline_match m = find_any_newline(b, siz, sep.lf, sep.cr, unit);
+            off = m.off;
+            nlen = off < siz && m.len == 0 ? unit : m.len;
+        }
+        else{
+            off = find_newline(b, siz, sep.lf, sep.lfs, unit);
+            nlen = off < siz ? sep.lfs : 0;
+        }
+        f(adv_string_view<T>{const_tchar_pt<T>{b, format}, off});
+        b += off + nlen;
+        siz -= off + nlen;
+    }
+}
+
+template<general_enctype T>
+std::vector<byte_range> line_chunks(const byte *b, size_t siz, EncMetric_info<T> format, const line_separators<T> &sep, size_t nthreads){
+    /*
+     * More chunks than threads balance the load, but they shouldn't be too small
+     */
+    constexpr size_t min_chunk = 1 << 16;
+    size_t n = pool_size(nthreads) * 4;
+    if(n > siz / min_chunk + 1)
+        n = siz / min_chunk + 1;
+    if(!format.has_head())
+        n = 1;
+    return split_at_newlines(b, siz, sep.lf, sep.lfs, n > 1 ? format.head() : 1, n);
+}
+
+template<general_enctype T, typename F>
+size_t parallel_lines_run(const byte *b, size_t siz, EncMetric_info<T> format, F &f, size_t nthreads, newline_mode mode){
+    line_separators<T> sep{format, mode};
+    std::vector<byte_range> chunks = line_chunks(b, siz, format, sep, nthreads);
+    std::atomic<size_t> nlines{0};
+    parallel_run(chunks.size(), nthreads, [&](size_t i){
+        size_t n = 0;
+        for_each_line_in(b + chunks[i].fir, chunks[i].las - chunks[i].fir, format, sep, mode, [&](const adv_string_view<T> &line){
+            f(line);
+            n++;
+        });
+        nlines.fetch_add(n, std::memory_order_relaxed);
+    });
+    return nlines.load();
+}
+
+template<general_enctype T, typename F>
+auto parallel_lines_map(const byte *b, size_t siz, EncMetric_info<T> format, F &f, merge_order order, size_t nthreads, newline_mode mode)
+    -> std::vector<std::invoke_result_t<F &, const adv_string_view<T> &>>
+{
+    using R = std::invoke_result_t<F &, const adv_string_view<T> &>;
+    line_separators<T> sep{format, mode};
+    std::vector<byte_range> chunks = line_chunks(b, siz, format, sep, nthreads);
+    std::vector<R> ret{};
+    if(order == merge_order::ordered){
+        std::vector<std::vector<R>> parts(chunks.size());
+        parallel_run(chunks.size(), nthreads, [&](size_t i){
+            for_each_line_in(b + chunks[i].fir, chunks[i].las - chunks[i].fir, format, sep, mode, [&](const adv_string_view<T> &line){
+                parts[i].push_back(f(line));
+            });
+        });
+        size_t tot = 0;
+        for(const std::vector<R> &p : parts)
+            tot += p.size();
+        ret.reserve(tot);
+        for(std::vector<R> &p : parts)
+            ret.insert(ret.end(), std::make_move_iterator(p.begin()), std::make_move_iterator(p.end()));
+    }
+    else{
+        std::mutex lck{};
+        parallel_run(chunks.size(), nthreads, [&](size_t i){
+            std::vector<R> part{};
+            for_each_line_in(b + chunks[i].fir, chunks[i].las - chunks[i].fir, format, sep, mode, [&](const adv_string_view<T> &line){
+                part.push_back(f(line));
+            });
+            std::lock_guard<std::mutex> g{lck};
+            ret.insert(ret.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        });
+    }
+    return ret;
+}
+
+template<general_enctype T, typename F>
+size_t parallel_for_each_line(const adv_string_view<T> &str, F &&f, size_t nthreads, newline_mode mode){
+    return parallel_lines_run(str.data(), str.size(), str.raw_format(), f, nthreads, mode);
+}
+
+template<general_enctype T, typename F>
+auto parallel_map_lines(const adv_string_view<T> &str, F &&f, merge_order order, size_t nthreads, newline_mode mode)
+    -> std::vector<std::invoke_result_t<F &, const adv_string_view<T> &>>
+{
+    return parallel_lines_map(str.data(), str.size(), str.raw_format(), f, order, nthreads, mode);
+}
+
+template<strong_enctype T, typename F>
+size_t parallel_for_each_line(const mapped_file &file, F &&f, size_t nthreads, newline_mode mode){
+    return parallel_lines_run(file.data() + file.bom_size(), file.size() - file.bom_size(), EncMetric_info<T>{}, f, nthreads, mode);
+}
+
+template<strong_enctype T, typename F>
+auto parallel_map_lines(const mapped_file &file, F &&f, merge_order order, size_t nthreads, newline_mode mode)
+    -> std::vector<std::invoke_result_t<F &, const adv_string_view<T> &>>
+{
+    return parallel_lines_map(file.data() + file.bom_size(), file.size() - file.bom_size(), EncMetric_info<T>{}, f, order, nthreads, mode);
+}
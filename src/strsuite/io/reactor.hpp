@@ -0,0 +1,246 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <strsuite/encmetric/base.hpp>
+#include <strsuite/io/enc_io_exc.hpp>
+
+namespace sts{
+
+template<typename R>
+struct task_result{
+    std::optional<R> value;
+
+    template<typename U>
+    void return_value(U &&v){ value.emplace(std::forward<U>(v));}
+    R get(){ return std::move(*value);}
+};
+
+template<>
+struct task_result<void>{
+    void return_void() noexcept{}
+    void get() noexcept{}
+};
+
+/*
+ * Lazy coroutine: it starts when it's awaited (or passed to a reactor) and resumes
+ * its awaiter when it ends
+ */
+template<typename R>
+class task{
+    public:
+        struct promise_type : task_result<R>{
+            std::coroutine_handle<> cont;
+            std::exception_ptr exc;
+
+            struct final_awaiter{
+                bool await_ready() const noexcept{ return false;}
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept{
+                    std::coroutine_handle<> c = h.promise().cont;
+                    if(c)
+                        return c;
+                    return std::noop_coroutine();
+                }
+                void await_resume() const noexcept{}
+            };
+
+            task get_return_object() noexcept{ return task{std::coroutine_handle<promise_type>::from_promise(*this)};}
+            std::suspend_always initial_suspend() const noexcept{ return {};}
+            final_awaiter final_suspend() const noexcept{ return {};}
+            void unhandled_exception() noexcept{ exc = std::current_exception();}
+        };
+    private:
+        std::coroutine_handle<promise_type> hnd;
+
+        explicit task(std::coroutine_handle<promise_type> h) noexcept : hnd{h} {}
+    public:
+        task(const task &) = delete;
+        task(task &&t) noexcept : hnd{std::exchange(t.hnd, nullptr)} {}
+        ~task(){
+            if(hnd)
+                hnd.destroy();
+        }
+        task &operator=(const task &) = delete;
+        task &operator=(task &&t) noexcept{
+            if(this != &t){
+                if(hnd)
+                    hnd.destroy();
+                hnd = std::exchange(t.hnd, nullptr);
+            }
+            return *this;
+        }
+
+        bool done() const noexcept{ return !hnd || hnd.done();}
+        /*
+         * Runs the coroutine until its first suspension
+         */
+        void start(){
+            if(hnd && !hnd.done())
+                hnd.resume();
+        }
+        /*
+         * Result of a terminated task, rethrows its exception
+         */
+        R result(){
+            if(hnd.promise().exc)
+                std::rethrow_exception(hnd.promise().exc);
+            return hnd.promise().get();
+        }
+
+        auto operator co_await() && noexcept{
+            struct awaiter{
+                std::coroutine_handle<promise_type> h;
+
+                bool await_ready() const noexcept{ return h.done();}
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept{
+                    h.promise().cont = c;
+                    return h;
+                }
+                R await_resume(){
+                    if(h.promise().exc)
+                        std::rethrow_exception(h.promise().exc);
+                    return h.promise().get();
+                }
+            };
+            return awaiter{hnd};
+        }
+};
+
+enum class io_event {read, write};
+
+/*
+ * Nonblocking system descriptor (not owned).
+ *
+ * read_wrap and write_wrap throw IOAGAIN when the operation would block, otherwise
+ * they follow the same rules of file_handle
+ */
+class async_fd{
+    private:
+        std::intptr_t handle;
+    public:
+        /*
+         * Sets the descriptor in nonblocking mode
+         */
+        explicit async_fd(std::intptr_t);
+
+        std::intptr_t native() const noexcept{ return handle;}
+        size_t read_wrap(byte *, size_t);
+        size_t write_wrap(const byte *, size_t);
+};
+
+/*
+ * Single threaded event loop based on epoll.
+ *
+ * Coroutines waiting for a descriptor are resumed by poll when the descriptor is ready; spawned
+ * tasks are owned by the reactor until they end
+ */
+class reactor{
+    private:
+        struct waiters{
+            std::coroutine_handle<> rd, wr;
+        };
+        std::intptr_t handle;
+        std::unordered_map<std::intptr_t, waiters> fds;
+        std::vector<task<void>> spawned;
+
+        void arm(std::intptr_t, io_event, std::coroutine_handle<>);
+        /*
+         * Destroys ended spawned tasks and rethrows their exceptions
+         */
+        void reap(){
+            for(size_t i=0; i<spawned.size();){
+                if(spawned[i].done()){
+                    task<void> t = std::move(spawned[i]);
+                    spawned.erase(spawned.begin() + static_cast<std::ptrdiff_t>(i));
+                    t.result();
+                }
+                else
+                    i++;
+            }
+        }
+    public:
+        struct io_wait{
+            reactor *rt;
+            std::intptr_t fd;
+            io_event ev;
+
+            bool await_ready() const noexcept{ return false;}
+            void await_suspend(std::coroutine_handle<> h){ rt->arm(fd, ev, h);}
+            void await_resume() const noexcept{}
+        };
+
+        reactor();
+        reactor(const reactor &) = delete;
+        ~reactor();
+        reactor &operator=(const reactor &) = delete;
+
+        /*
+         * co_await rt.wait(fd, io_event::read) suspends the coroutine until fd is readable
+         */
+        io_wait wait(std::intptr_t fd, io_event ev) noexcept{ return io_wait{this, fd, ev};}
+        /*
+         * Removes the descriptor from the reactor, call it before closing fd
+         */
+        void forget(std::intptr_t fd) noexcept;
+        /*
+         * Waits at most timeout milliseconds (forever if negative) and resumes all the ready coroutines,
+         * returns the number of resumed coroutines
+         */
+        size_t poll(int timeout = -1);
+        size_t pending() const noexcept;
+
+        void spawn(task<void> t){
+            spawned.push_back(std::move(t));
+            spawned.back().start();
+            reap();
+        }
+        /*
+         * Runs until all the spawned tasks end
+         */
+        void run(){
+            while(!spawned.empty()){
+                if(pending() == 0)
+                    throw InvalidOP{};
+                poll();
+                reap();
+            }
+        }
+        /*
+         * Runs t (and the spawned tasks) until t ends, then returns its result.
+         * Throws InvalidOP if t is suspended but no coroutine is waiting for a descriptor
+         */
+        template<typename R>
+        R run(task<R> t){
+            t.start();
+            while(!t.done()){
+                if(pending() == 0)
+                    throw InvalidOP{};
+                poll();
+                reap();
+            }
+            return t.result();
+        }
+};
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <optional>
+#include <strsuite/io/string_stream.hpp>
+#include <strsuite/io/temp_file.hpp>
+
+namespace sts{
+
+/*
+ * A write-only string_stream whose memory usage is bounded: when the in-memory window exceeds its
+ * limit it's moved to an anonymous temporary file, so huge outputs don't need to be stored in RAM.
+ *
+ * Lengths and sizes take into account both the window and the spilled data
+ */
+template<general_enctype T>
+class spill_stream{
+    private:
+        string_stream<T> window;
+        std::optional<temp_file> file;
+        size_t limit;
+        size_t flen;
+        std::pmr::memory_resource *alloc;
+
+        static constexpr size_t chunk_size = 1 << 16;
+
+        temp_file &get_file();
+        void spill();
+        void check_spill(){
+            if(window.size() >= limit)
+                spill();
+        }
+    public:
+        using ctype = typename T::ctype;
+        static constexpr size_t default_window = 1 << 20;
+
+        spill_stream(EncMetric_info<T> info, size_t window_size = default_window, std::pmr::memory_resource *all = std::pmr::get_default_resource())
+            : window{info, all}, file{}, limit{window_size == 0 ? 1 : window_size}, flen{0}, alloc{all} {}
+        spill_stream(size_t window_size = default_window, std::pmr::memory_resource *all = std::pmr::get_default_resource()) requires strong_enctype<T>
+            : spill_stream{EncMetric_info<T>{}, window_size, all} {}
+        spill_stream(const EncMetric<ctype> *f, size_t window_size = default_window, std::pmr::memory_resource *all = std::pmr::get_default_resource()) requires widenc<T>
+            : spill_stream{EncMetric_info<T>{f}, window_size, all} {}
+
+        size_t size() const noexcept {return spilled() + window.size();}
+        size_t length() const noexcept {return flen + window.length();}
+        /*
+         * Bytes stored in the temporary file
+         */
+        size_t spilled() const noexcept {return file ? static_cast<size_t>(file->size()) : 0;}
+        size_t window_size() const noexcept {return limit;}
+        EncMetric_info<T> raw_format() const noexcept {return window.raw_format();}
+
+        void discard();
+
+        template<general_enctype S>
+        uint char_write(const_tchar_pt<S> pt, size_t siz){
+            uint ret = window.char_write(pt, siz);
+            check_spill();
+            return ret;
+        }
+        template<general_enctype S>
+        uint char_write(tchar_pt<S> pt, size_t siz){ return char_write(pt.cast(), siz);}
+        /*
+         * Strings bigger than the window are written directly to the file
+         */
+        template<general_enctype S>
+        size_t string_write(const adv_string_view<S> &);
+        uint ctype_write(const ctype &c){
+            uint ret = window.ctype_write(c);
+            check_spill();
+            return ret;
+        }
+        void flush() noexcept {}
+
+        /*
+         * Write all the stored data to a stream and empty this stream
+         */
+        template<typename OStream> requires write_char_stream<OStream, T>
+        size_t put_all(OStream &);
+        template<write_byte_stream OBStream>
+        void put_all_char_bytes(OBStream &);
+        /*
+         * Loads all the data inside a string, use it only if you know it fits in memory
+         */
+        adv_string<T> move();
+};
+
+#include <strsuite/io/spill_stream.tpp>
+}
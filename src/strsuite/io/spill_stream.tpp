@@ -0,0 +1,129 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T>
+temp_file &spill_stream<T>::get_file(){
+    if(!file)
+        file.emplace();
+    return *file;
+}
+
+template<general_enctype T>
+void spill_stream<T>::spill(){
+    size_t wlen = window.length();
+    if(wlen == 0)
+        return;
+    window.put_all_char_bytes(get_file());
+    flen += wlen;
+}
+
+template<general_enctype T>
+void spill_stream<T>::discard(){
+    window.discard();
+    if(file)
+        file->clear();
+    flen = 0;
+}
+
+template<general_enctype T>
+template<general_enctype S>
+size_t spill_stream<T>::string_write(const adv_string_view<S> &strS){
+    adv_string_view<T> str = strS.rebase(raw_format());
+    if(window.size() + str.size() < limit)
+        return window.string_write(str);
+    spill();
+    if(str.size() < limit)
+        return window.string_write(str);
+    force_byte_write(get_file(), str.data(), str.size());
+    flen += str.length();
+    return str.size();
+}
+
+template<general_enctype T>
+template<typename OStream> requires write_char_stream<OStream, T>
+size_t spill_stream<T>::put_all(OStream &stm){
+    if(length() == 0)
+        throw IOEOF{};
+    size_t ret = 0;
+    if(spilled() > 0){
+        /*
+         * Chunks may split a character, the incomplete part is moved to the next chunk
+         */
+        basic_ptr buf{chunk_size, alloc};
+        std::uint64_t off = 0;
+        size_t have = 0;
+        while(off < file->size()){
+            size_t red = file->read_at(buf.memory + have, buf.dimension - have, off);
+            if(red == 0)
+                throw IOFail{"Temporary file truncated"};
+            off += red;
+            have += red;
+            dimensions dim = deduce_lens(const_tchar_pt<T>{buf.memory, raw_format()}, have);
+            if(dim.siz == 0)
+                buf.exp_fit(buf.dimension + 1);
+            else{
+                ret += stm.string_write(direct_build(const_tchar_pt<T>{buf.memory, raw_format()}, dim.len, dim.siz));
+                have -= dim.siz;
+                move_bytes(buf.memory, buf.memory + dim.siz, have);
+            }
+        }
+        file->clear();
+        flen = 0;
+    }
+    if(window.length() > 0)
+        ret += window.put_all(stm);
+    return ret;
+}
+
+template<general_enctype T>
+template<write_byte_stream OBStream>
+void spill_stream<T>::put_all_char_bytes(OBStream &stm){
+    if(spilled() > 0){
+        basic_ptr buf{chunk_size, alloc};
+        std::uint64_t off = 0;
+        while(off < file->size()){
+            size_t red = file->read_at(buf.memory, buf.dimension, off);
+            if(red == 0)
+                throw IOFail{"Temporary file truncated"};
+            force_byte_write(stm, buf.memory, red);
+            off += red;
+        }
+        file->clear();
+        flen = 0;
+    }
+    window.put_all_char_bytes(stm);
+}
+
+template<general_enctype T>
+adv_string<T> spill_stream<T>::move(){
+    if(spilled() == 0)
+        return window.move();
+    size_t fsiz = spilled();
+    basic_ptr res{size(), alloc};
+    size_t off = 0;
+    while(off < fsiz){
+        size_t red = file->read_at(res.memory + off, fsiz - off, off);
+        if(red == 0)
+            throw IOFail{"Temporary file truncated"};
+        off += red;
+    }
+    copy_bytes(res.memory + fsiz, window.view().data(), window.size());
+    size_t rlen = length(), rsiz = size();
+    discard();
+    return direct_build_dyn(std::move(res), rlen, rsiz, raw_format());
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <strsuite/encmetric/basic_ptr.hpp>
+#include <strsuite/io/char_stream.hpp>
+
+namespace sts{
+
+/*
+ * Validates an encoded byte stream chunk by chunk without storing it.
+ *
+ * Bytes of a character splitted between two chunks are kept until the next chunk. When an invalid
+ * sequence is found the validator stops and remembers its byte and character offsets from the
+ * beginning of the stream, no exception is thrown
+ */
+template<general_enctype T>
+class stream_validator{
+    private:
+        enum class char_state {complete, incomplete, invalid};
+        struct char_check{
+            char_state state;
+            uint len;
+        };
+
+        static constexpr size_t carry_size = 32;
+
+        EncMetric_info<T> format;
+        byte carry[carry_size];
+        size_t clen;
+        size_t nbytes, nchars;
+        bool failed;
+        /*
+         * Every byte lesser than 0x80 is an encoded ASCII character
+         */
+        bool ascii_compatible;
+
+        char_check check_char(const byte *, size_t) const noexcept;
+        bool fail() noexcept{
+            failed = true;
+            return false;
+        }
+    public:
+        explicit stream_validator(EncMetric_info<T>) noexcept;
+        stream_validator() noexcept requires strong_enctype<T> : stream_validator{EncMetric_info<T>{}} {}
+
+        /*
+         * Validates the next chunk, returns false if the stream contains an invalid sequence
+         */
+        bool feed(const byte *, size_t);
+        /*
+         * Call it at the end of the stream: an incomplete last character is invalid
+         */
+        bool finish() noexcept;
+        void reset() noexcept;
+
+        bool valid() const noexcept{ return !failed;}
+        /*
+         * Validated bytes and characters, when the stream is invalid they're also the offsets
+         * of the first invalid sequence
+         */
+        size_t bytes() const noexcept{ return nbytes;}
+        size_t chars() const noexcept{ return nchars;}
+        size_t error_byte() const noexcept{ return nbytes;}
+        size_t error_char() const noexcept{ return nchars;}
+        size_t carried() const noexcept{ return clen;}
+        EncMetric_info<T> raw_format() const noexcept{ return format;}
+};
+
+/*
+ * Validates a whole stream
+ */
+template<general_enctype T, read_byte_stream IBStream>
+stream_validator<T> validate_stream(IBStream &, EncMetric_info<T>, size_t bufsiz = 1 << 16);
+
+template<strong_enctype T, read_byte_stream IBStream>
+stream_validator<T> validate_stream(IBStream &stream, size_t bufsiz = 1 << 16){
+    return validate_stream(stream, EncMetric_info<T>{}, bufsiz);
+}
+
+#include <strsuite/io/stream_validator.tpp>
+}
@@ -0,0 +1,128 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype T>
+stream_validator<T>::stream_validator(EncMetric_info<T> f) noexcept : format{f}, carry{}, clen{0}, nbytes{0}, nchars{0}, failed{false}, ascii_compatible{false} {
+    if constexpr(std::same_as<typename T::ctype, unicode>)
+        ascii_compatible = EncMetric_info<ASCII>{}.base_for(format);
+}
+
+template<general_enctype T>
+void stream_validator<T>::reset() noexcept{
+    clen = 0;
+    nbytes = 0;
+    nchars = 0;
+    failed = false;
+}
+
+template<general_enctype T>
+typename stream_validator<T>::char_check stream_validator<T>::check_char(const byte *b, size_t siz) const noexcept{
+    uint chl;
+    try{
+        chl = format.chLen(b, siz);
+    }
+    catch(buffer_small &){
+        return char_check{char_state::incomplete, 0};
+    }
+    catch(...){
+        return char_check{char_state::invalid, 0};
+    }
+    if(chl > siz)
+        return char_check{char_state::incomplete, 0};
+    if(chl == 0 || !format.validChar(b, chl))
+        return char_check{char_state::invalid, 0};
+    return char_check{char_state::complete, chl};
+}
+
+template<general_enctype T>
+bool stream_validator<T>::feed(const byte *b, size_t siz){
+    if(failed)
+        return false;
+    if(clen > 0){
+        /*
+         * Completes the carried character
+         */
+        size_t k = siz < carry_size - clen ? siz : carry_size - clen;
+        copy_bytes(carry + clen, b, k);
+        char_check r = check_char(carry, clen + k);
+        if(r.state == char_state::invalid)
+            return fail();
+        if(r.state == char_state::incomplete){
+            clen += k;
+            if(clen == carry_size)
+                return fail();
+            return true;
+        }
+        size_t used = r.len - clen;
+        b += used;
+        siz -= used;
+        nbytes += r.len;
+        nchars++;
+        clen = 0;
+    }
+    size_t i = 0;
+    while(i < siz){
+        if(ascii_compatible){
+            size_t asc = ascii_prefix(b + i, siz - i);
+            i += asc;
+            nbytes += asc;
+            nchars += asc;
+            if(i == siz)
+                break;
+        }
+        char_check r = check_char(b + i, siz - i);
+        if(r.state == char_state::invalid)
+            return fail();
+        if(r.state == char_state::incomplete){
+            if(siz - i > carry_size)
+                return fail();
+            copy_bytes(carry, b + i, siz - i);
+            clen = siz - i;
+            break;
+        }
+        i += r.len;
+        nbytes += r.len;
+        nchars++;
+    }
+    return true;
+}
+
+template<general_enctype T>
+bool stream_validator<T>::finish() noexcept{
+    if(!failed && clen > 0)
+        return fail();
+    return !failed;
+}
+
+template<general_enctype T, read_byte_stream IBStream>
+stream_validator<T> validate_stream(IBStream &stream, EncMetric_info<T> f, size_t bufsiz){
+    stream_validator<T> ret{f};
+    basic_ptr buf{bufsiz < 16 ? 16 : bufsiz};
+    while(true){
+        size_t rd;
+        try{
+            rd = stream.read(buf.memory, buf.dimension);
+        }
+        catch(IOEOF &){
+            ret.finish();
+            return ret;
+        }
+        if(!ret.feed(buf.memory, rd))
+            return ret;
+    }
+}
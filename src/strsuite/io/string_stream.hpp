@@ -19,6 +19,7 @@
 */
 #include <strsuite/encmetric/basic_ptr.hpp>
 #include <strsuite/encmetric/enc_string.hpp>
+#include <strsuite/encmetric/string_arena.hpp>
 #include <strsuite/io/char_stream.hpp>
 #include <strsuite/io/buffers.hpp>
 
@@ -48,9 +49,30 @@ namespace sts{
         size_t length() const noexcept {return len;}
         size_t remaining() const noexcept {return this->rem;}
         void discard() noexcept;
+        /*
+         * Bytes that can be stored without reallocating the buffer
+         */
+        size_t capacity() const noexcept {return buffer.dimension;}
+        /*
+         * Makes room for at least nbytes more bytes, the buffer grows geometrically
+         */
+        void reserve(size_t nbytes);
+        /*
+         * Makes room for at least nchr more characters when the encoding has a maximum character
+         * length, otherwise for their minimum size
+         */
+        void reserve_chars(size_t nchr);
+        /*
+         * Reduces the buffer to the stored string
+         */
+        void shrink_to_fit();
 
         adv_string_view<T> view() const noexcept {return direct_build(const_tchar_pt{this->base + this->fir, format}, len, this->siz);}
         adv_string<T> move();
+        /*
+         * Copies the string inside the arena and empties the buffer, that can be reused
+         */
+        adv_string<T> move(string_arena &);
         adv_string<T> allocate_new(std::pmr::memory_resource *res) const;
         adv_string<T> allocate_new() const {return allocate_new(buffer.get_allocator());}
         template<general_enctype S>
@@ -64,6 +86,13 @@ namespace sts{
         uint char_write(const_tchar_pt<S>, size_t);
         template<general_enctype S>
         size_t string_write(const adv_string_view<S> &);
+        /*
+         * Bulk versions of char_read and char_write, whole blocks of characters are copied at once
+         */
+        template<general_enctype S>
+        dimensions string_read(tchar_pt<S>, size_t, size_t max_chars = std::numeric_limits<size_t>::max());
+        template<general_enctype S>
+        dimensions chars_write(const_tchar_pt<S>, size_t, size_t max_chars = std::numeric_limits<size_t>::max());
 
         template<typename IStream> requires read_char_stream<IStream, T>
         uint get_char(IStream &);
@@ -33,6 +33,38 @@ void string_stream<T>::discard() noexcept{
     this->discard_all();
 }
 
+template<general_enctype T>
+void string_stream<T>::reserve(size_t nbytes){
+    this->rewind_for(nbytes);
+    if(this->rem >= nbytes)
+        return;
+    buffer.exp_fit(this->las + nbytes);
+    this->rebase(buffer.memory, buffer.dimension);
+}
+
+template<general_enctype T>
+void string_stream<T>::reserve_chars(size_t nchr){
+    if(format.has_max())
+        reserve(nchr * format.max_bytes());
+    else
+        reserve(nchr * format.min_bytes());
+}
+
+template<general_enctype T>
+void string_stream<T>::shrink_to_fit(){
+    this->rewind();
+    if(buffer.dimension == this->siz)
+        return;
+    if(this->siz == 0){
+        buffer.free();
+        this->reset();
+    }
+    else{
+        buffer.reallocate(this->siz);
+        this->rebase(buffer.memory, buffer.dimension);
+    }
+}
+
 template<general_enctype T>
 template<typename IStream> requires read_char_stream<IStream, T>
 uint string_stream<T>::get_char(IStream &stm){
@@ -223,6 +255,68 @@ size_t string_stream<T>::string_write(const adv_string_view<S> &strS){
     return chsi;
 }
 
+template<general_enctype T>
+template<general_enctype S>
+dimensions string_stream<T>::string_read(tchar_pt<S> ptrS, size_t tsiz, size_t max_chars){
+    tchar_pt<T> ptr = inv_rebase_pointer(ptrS, format);
+    if(len == 0)
+        throw IOEOF{};
+    dimensions ret = measure_chars(format, this->base + this->fir, tsiz < this->siz ? tsiz : this->siz, max_chars < len ? max_chars : len);
+    if(ret.len == 0){
+        if(max_chars > 0)
+            throw IOBufsmall{format.chLen(this->base + this->fir, this->siz) - static_cast<uint>(tsiz)};
+        return ret;
+    }
+    copy_bytes(ptr.data(), this->base + this->fir, ret.siz);
+    len -= ret.len;
+    this->raw_fir_step(ret.siz);
+    return ret;
+}
+
+template<general_enctype T>
+template<general_enctype S>
+dimensions string_stream<T>::chars_write(const_tchar_pt<S> pt, size_t tsiz, size_t max_chars){
+    dimensions ret{};
+    if(pt.raw_format().base_for(format)){
+        ret = measure_chars(format, pt.data(), tsiz, max_chars);
+        if(ret.len > 0){
+            this->force_rem(ret.siz);
+            copy_bytes(this->base + this->las, pt.data(), ret.siz);
+            len += ret.len;
+            this->raw_las_step(ret.siz);
+            return ret;
+        }
+    }
+    else{
+        ret = measure_chars(pt.raw_format(), pt.data(), tsiz, max_chars);
+        reserve_chars(ret.len);
+        const_tchar_pt<S> it = pt;
+        size_t rem = ret.siz;
+        for(size_t i=0; i<ret.len; i++){
+            uint chl = it.chLen(rem);
+            char_write_conv_0(it, rem);
+            it += chl;
+            rem -= chl;
+        }
+        if(ret.len > 0)
+            return ret;
+    }
+    /*
+     * The first character is incomplete
+     */
+    if(tsiz > 0 && max_chars > 0){
+        uint chl;
+        try{
+            chl = pt.chLen(tsiz);
+        }
+        catch(buffer_small &e){
+            throw IOBufsmall{e};
+        }
+        throw IOBufsmall{chl - static_cast<uint>(tsiz)};
+    }
+    return ret;
+}
+
 template<general_enctype T>
 template<general_enctype R>
 uint string_stream<T>::char_write(const_tchar_pt<R> pt, size_t buf){
@@ -247,6 +341,8 @@ uint string_stream<T>::char_write_conv_0(const_tchar_pt<R> pt, size_t buf){
     ctype temp = get_chr_el(assume);
     uint ret;
     bool enc=false;
+    if(format.has_max())
+        this->force_rem(format.max_bytes());
     do{
         try{
             ret = format.encode(temp, this->base + this->las, this->rem);
@@ -300,6 +396,11 @@ template<general_enctype T>
 uint string_stream<T>::ctype_write(const ctype &c){
     uint ret;
     bool ext=false;
+    /*
+     * Avoids catching buffer_small when the encoded length is bounded
+     */
+    if(format.has_max())
+        this->force_rem(format.max_bytes());
     do{
         try{
             ret = format.encode(c, this->base + this->las, this->rem);
@@ -337,6 +438,14 @@ feat::Proxy_wrapper_ctype<T> string_stream<T>::light_ctype_read() requires stron
 
 template<general_enctype T>
 adv_string<T> string_stream<T>::move(){
+    if(this->siz <= adv_string<T>::sso_capacity){
+        /*
+         * Short strings are copied inside the adv_string object, so we can keep our buffer
+         */
+        adv_string<T> ret{view(), buffer.get_allocator()};
+        discard();
+        return ret;
+    }
     this->rewind();
     basic_ptr res = std::move(buffer);
     buffer.leave();
@@ -346,6 +455,13 @@ adv_string<T> string_stream<T>::move(){
     return direct_build_dyn(std::move(res), rlen, rsiz, format);
 }
 
+template<general_enctype T>
+adv_string<T> string_stream<T>::move(string_arena &arena){
+    adv_string<T> ret = arena.alloc_string(view());
+    discard();
+    return ret;
+}
+
 template<general_enctype T>
 adv_string<T> string_stream<T>::allocate_new(std::pmr::memory_resource *res) const{
     adv_string_view<T> vw = direct_build(const_tchar_pt{this->base + this->fir, format}, len, this->siz);
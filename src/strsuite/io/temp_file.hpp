@@ -0,0 +1,74 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdint>
+#include <strsuite/encmetric/base.hpp>
+#include <strsuite/io/enc_io_exc.hpp>
+
+namespace sts{
+
+/*
+ * Anonymous temporary file, it's removed from the file system as soon as it's created so its content
+ * disappears when the object is destroyed or the program terminates.
+ *
+ * Data is always appended at the end of the file and can be read from any position
+ */
+class temp_file{
+    private:
+        std::intptr_t handle;
+        std::uint64_t fsiz;
+
+        static std::intptr_t open_temp();
+        void close_temp() noexcept;
+    public:
+        /*
+         * Throws IOFail if the file cannot be created
+         */
+        temp_file() : handle{open_temp()}, fsiz{0} {}
+        temp_file(const temp_file &) = delete;
+        temp_file(temp_file &&t) noexcept : handle{t.handle}, fsiz{t.fsiz} {
+            t.handle = -1;
+            t.fsiz = 0;
+        }
+        ~temp_file(){ close_temp();}
+        temp_file &operator=(const temp_file &) = delete;
+        temp_file &operator=(temp_file &&t) noexcept{
+            close_temp();
+            handle = t.handle;
+            fsiz = t.fsiz;
+            t.handle = -1;
+            t.fsiz = 0;
+            return *this;
+        }
+
+        std::uint64_t size() const noexcept{ return fsiz;}
+        /*
+         * Appends data at the end of the file, it's a write_byte_stream
+         */
+        size_t write(const byte *, size_t);
+        /*
+         * Reads at most siz bytes starting from off, returns 0 only at the end of the file
+         */
+        size_t read_at(byte *, size_t siz, std::uint64_t off) const;
+        /*
+         * Removes all the data
+         */
+        void clear();
+};
+
+}
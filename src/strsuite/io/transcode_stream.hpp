@@ -0,0 +1,119 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdint>
+#include <strsuite/encmetric/basic_ptr.hpp>
+#include <strsuite/io/char_stream.hpp>
+
+namespace sts{
+
+struct transcode_result{
+    size_t read, written, chars;
+    /*
+     * The output buffer can't contain the next character
+     */
+    bool full;
+};
+
+/*
+ * Converts all the complete characters in the input buffer until the output buffer is full.
+ * Incomplete characters at the end of the input are not read, throws incorrect_encoding
+ * if the input is not correctly encoded
+ */
+template<general_enctype S, general_enctype T>
+transcode_result transcode_chunk(EncMetric_info<S>, const byte *, size_t, EncMetric_info<T>, byte *, size_t);
+
+/*
+ * Reads characters encoded with S from a byte stream and returns them encoded with T.
+ * Data is converted in chunks of fixed size, so the memory usage doesn't depend on the stream size.
+ *
+ * It's also a read_byte_stream: read throws IOEOF at the end of the stream and IOIncomplete
+ * if the stream ends with an incomplete character
+ */
+template<general_enctype S, general_enctype T, read_byte_stream IBStream>
+class transcode_istream{
+    private:
+        IBStream &stream;
+        EncMetric_info<S> from;
+        EncMetric_info<T> to;
+        basic_ptr ibuf, obuf;
+        size_t ifir, ilas, ofir, olas;
+        bool ended;
+
+        size_t convert(byte *, size_t);
+    public:
+        static constexpr size_t default_buffer = 1 << 16;
+
+        transcode_istream(IBStream &, EncMetric_info<S>, EncMetric_info<T>, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        explicit transcode_istream(IBStream &s, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<S> && strong_enctype<T>
+            : transcode_istream{s, EncMetric_info<S>{}, EncMetric_info<T>{}, bufsiz, alloc} {}
+        transcode_istream(const transcode_istream &) = delete;
+        transcode_istream &operator=(const transcode_istream &) = delete;
+
+        size_t read(byte *, size_t);
+        bool eof() const noexcept{ return ended && ifir == ilas && ofir == olas;}
+};
+
+/*
+ * Accepts characters encoded with S and writes them to a byte stream encoded with T.
+ *
+ * Bytes of an incomplete character are kept until the next write, flush writes only the converted data
+ */
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+class transcode_ostream{
+    private:
+        OBStream &stream;
+        EncMetric_info<S> from;
+        EncMetric_info<T> to;
+        basic_ptr ibuf, obuf;
+        size_t ilas, olas;
+
+        static constexpr size_t carry_size = 32;
+
+        size_t convert(const byte *, size_t);
+    public:
+        static constexpr size_t default_buffer = 1 << 16;
+
+        transcode_ostream(OBStream &, EncMetric_info<S>, EncMetric_info<T>, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource());
+        explicit transcode_ostream(OBStream &s, size_t bufsiz = default_buffer, std::pmr::memory_resource *alloc = std::pmr::get_default_resource()) requires strong_enctype<S> && strong_enctype<T>
+            : transcode_ostream{s, EncMetric_info<S>{}, EncMetric_info<T>{}, bufsiz, alloc} {}
+        transcode_ostream(const transcode_ostream &) = delete;
+        ~transcode_ostream();
+        transcode_ostream &operator=(const transcode_ostream &) = delete;
+
+        size_t write(const byte *, size_t);
+        void flush();
+        /*
+         * Bytes of the last incomplete character
+         */
+        size_t carried() const noexcept{ return ilas;}
+};
+
+/*
+ * Converts a whole stream, returns the number of written bytes
+ */
+template<general_enctype S, general_enctype T, read_byte_stream IBStream, write_byte_stream OBStream>
+size_t transcode_all(IBStream &, EncMetric_info<S>, OBStream &, EncMetric_info<T>, size_t bufsiz = transcode_istream<S, T, IBStream>::default_buffer);
+
+template<strong_enctype S, strong_enctype T, read_byte_stream IBStream, write_byte_stream OBStream>
+size_t transcode_all(IBStream &in, OBStream &out, size_t bufsiz = transcode_istream<S, T, IBStream>::default_buffer){
+    return transcode_all(in, EncMetric_info<S>{}, out, EncMetric_info<T>{}, bufsiz);
+}
+
+#include <strsuite/io/transcode_stream.tpp>
+}
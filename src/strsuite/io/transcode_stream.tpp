@@ -0,0 +1,212 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+template<general_enctype S, general_enctype T>
+transcode_result transcode_chunk(EncMetric_info<S> from, const byte *in, size_t isiz, EncMetric_info<T> to, byte *out, size_t osiz){
+    transcode_result ret{0, 0, 0, false};
+    if(from.base_for(to)){
+        /*
+         * Characters are only validated and copied
+         */
+        const size_t lim = isiz < osiz ? isiz : osiz;
+        while(ret.read < lim){
+            uint chl;
+            try{
+                chl = from.chLen(in + ret.read, lim - ret.read);
+            }
+            catch(buffer_small &){
+                break;
+            }
+            if(chl > lim - ret.read)
+                break;
+            if(!from.validChar(in + ret.read, chl))
+                throw incorrect_encoding{"Invalid character"};
+            ret.read += chl;
+            ret.chars++;
+        }
+        copy_bytes(out, in, ret.read);
+        ret.written = ret.read;
+        ret.full = ret.read < isiz && lim == osiz;
+        return ret;
+    }
+    while(ret.read < isiz){
+        uint chl;
+        try{
+            chl = from.chLen(in + ret.read, isiz - ret.read);
+        }
+        catch(buffer_small &){
+            break;
+        }
+        if(chl > isiz - ret.read)
+            break;
+        typename S::ctype c = from.decode_direct(in + ret.read, chl);
+        try{
+            ret.written += to.encode(c, out + ret.written, osiz - ret.written);
+        }
+        catch(buffer_small &){
+            ret.full = true;
+            break;
+        }
+        ret.read += chl;
+        ret.chars++;
+    }
+    return ret;
+}
+
+template<general_enctype S, general_enctype T, read_byte_stream IBStream>
+transcode_istream<S, T, IBStream>::transcode_istream(IBStream &s, EncMetric_info<S> f, EncMetric_info<T> t, size_t bufsiz, std::pmr::memory_resource *alloc)
+    : stream{s}, from{f}, to{t}, ibuf{bufsiz < 16 ? 16 : bufsiz, alloc}, obuf{bufsiz < 16 ? 16 : bufsiz, alloc}, ifir{0}, ilas{0}, ofir{0}, olas{0}, ended{false} {}
+
+template<general_enctype S, general_enctype T, read_byte_stream IBStream>
+size_t transcode_istream<S, T, IBStream>::convert(byte *out, size_t osiz){
+    while(true){
+        transcode_result r = transcode_chunk(from, ibuf.memory + ifir, ilas - ifir, to, out, osiz);
+        ifir += r.read;
+        if(r.written > 0)
+            return r.written;
+        if(ended){
+            if(ifir == ilas)
+                throw IOEOF{};
+            throw IOIncomplete{};
+        }
+        /*
+         * Bytes of an incomplete character are moved at the beginning of the buffer
+         */
+        move_bytes(ibuf.memory, ibuf.memory + ifir, ilas - ifir);
+        ilas -= ifir;
+        ifir = 0;
+        try{
+            ilas += stream.read(ibuf.memory + ilas, ibuf.dimension - ilas);
+        }
+        catch(IOEOF &){
+            ended = true;
+        }
+    }
+}
+
+template<general_enctype S, general_enctype T, read_byte_stream IBStream>
+size_t transcode_istream<S, T, IBStream>::read(byte *b, size_t siz){
+    if(siz == 0)
+        return 0;
+    if(ofir == olas){
+        /*
+         * Big reads are converted directly in the destination
+         */
+        if(siz >= obuf.dimension)
+            return convert(b, siz);
+        olas = convert(obuf.memory, obuf.dimension);
+        ofir = 0;
+    }
+    size_t ret = siz < olas - ofir ? siz : olas - ofir;
+    copy_bytes(b, obuf.memory + ofir, ret);
+    ofir += ret;
+    return ret;
+}
+
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+transcode_ostream<S, T, OBStream>::transcode_ostream(OBStream &s, EncMetric_info<S> f, EncMetric_info<T> t, size_t bufsiz, std::pmr::memory_resource *alloc)
+    : stream{s}, from{f}, to{t}, ibuf{carry_size, alloc}, obuf{bufsiz < 16 ? 16 : bufsiz, alloc}, ilas{0}, olas{0} {}
+
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+transcode_ostream<S, T, OBStream>::~transcode_ostream(){
+    try{
+        flush();
+    }
+    catch(...){}
+}
+
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+void transcode_ostream<S, T, OBStream>::flush(){
+    force_byte_write(stream, obuf.memory, olas);
+    olas = 0;
+}
+
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+size_t transcode_ostream<S, T, OBStream>::convert(const byte *in, size_t isiz){
+    size_t done = 0;
+    while(true){
+        transcode_result r = transcode_chunk(from, in + done, isiz - done, to, obuf.memory + olas, obuf.dimension - olas);
+        done += r.read;
+        olas += r.written;
+        if(!r.full)
+            return done;
+        flush();
+    }
+}
+
+template<general_enctype S, general_enctype T, write_byte_stream OBStream>
+size_t transcode_ostream<S, T, OBStream>::write(const byte *b, size_t siz){
+    const size_t ret = siz;
+    while(siz > 0){
+        if(ilas == 0){
+            /*
+             * Only the last incomplete character is copied
+             */
+            size_t rd = convert(b, siz);
+            b += rd;
+            siz -= rd;
+            if(siz > ibuf.dimension)
+                throw IOIncomplete{};
+            copy_bytes(ibuf.memory, b, siz);
+            ilas = siz;
+            siz = 0;
+        }
+        else{
+            size_t k = siz < ibuf.dimension - ilas ? siz : ibuf.dimension - ilas;
+            copy_bytes(ibuf.memory + ilas, b, k);
+            ilas += k;
+            b += k;
+            siz -= k;
+            size_t rd = convert(ibuf.memory, ilas);
+            size_t left = ilas - rd;
+            if(left <= k){
+                /*
+                 * The carried character has been completed, remaining bytes are read again from b
+                 */
+                b -= left;
+                siz += left;
+                ilas = 0;
+            }
+            else{
+                move_bytes(ibuf.memory, ibuf.memory + rd, left);
+                ilas = left;
+                if(siz > 0)
+                    throw IOIncomplete{};
+            }
+        }
+    }
+    return ret;
+}
+
+template<general_enctype S, general_enctype T, read_byte_stream IBStream, write_byte_stream OBStream>
+size_t transcode_all(IBStream &in, EncMetric_info<S> from, OBStream &out, EncMetric_info<T> to, size_t bufsiz){
+    transcode_istream<S, T, IBStream> conv{in, from, to, bufsiz};
+    basic_ptr buf{bufsiz < 16 ? 16 : bufsiz};
+    size_t ret = 0;
+    while(true){
+        size_t rd;
+        try{
+            rd = conv.read(buf.memory, buf.dimension);
+        }
+        catch(IOEOF &){
+            return ret;
+        }
+        force_byte_write(out, buf.memory, rd);
+        ret += rd;
+    }
+}
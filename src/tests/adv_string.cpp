@@ -0,0 +1,70 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string>
+#include <strsuite/encmetric.hpp>
+#include <strsuite/encmetric/shared_string.hpp>
+#include "check.hpp"
+
+using namespace sts;
+
+int main(){
+    const adv_string_view<UTF8> lng = u8"0123456789012345678901234567890123456789"_asv;
+    std::pmr::memory_resource *res = std::pmr::get_default_resource();
+
+    /*
+     * Moved from strings are empty and can be modified
+     */
+    adv_string<UTF8> a{lng, res};
+    adv_string<UTF8> b{std::move(a)};
+    STS_CHECK(b == lng && a.size() == 0 && a.length() == 0);
+    a.append(lng);
+    a.push_back(unicode{0x20ACu});
+    STS_CHECK(a.size() == lng.size() + 3 && a.length() == lng.length() + 1);
+
+    adv_string<UTF8> s{u8"short"_asv, res};
+    adv_string<UTF8> s2{std::move(s)};
+    STS_CHECK(s2 == u8"short"_asv && s2.is_local() && s.size() == 0);
+    s.append(lng);
+    STS_CHECK(s == lng);
+
+    adv_string<UTF8> c{lng, res};
+    shared_string<UTF8> sh{std::move(c)};
+    STS_CHECK(sh == lng && c.size() == 0);
+    c.append(u8"xyz"_asv);
+    STS_CHECK(c == u8"xyz"_asv && sh == lng);
+
+    /*
+     * Local buffer and heap pointer share the same memory
+     */
+    STS_CHECK(sizeof(adv_string<UTF8>) <= sizeof(adv_string_view<UTF8>) + sizeof(void *) + adv_string<UTF8>::sso_capacity);
+    adv_string<UTF8> g{u8"ab"_asv, res};
+    for(int i=0; i<100; i++)
+        g.append(u8"è"_asv);
+    STS_CHECK(!g.is_local() && g.length() == 102 && g.get_char(101) == unicode{0xE8u});
+
+    /*
+     * Containers are adopted without copying them
+     */
+    std::string text(100, 'x');
+    const char *data = text.data();
+    adv_string<UTF8> ad = adopt_string<UTF8>(std::move(text));
+    STS_CHECK(ad.data() == reinterpret_cast<const byte *>(data) && ad.size() == 100);
+    ad.append(lng);
+    STS_CHECK(ad.size() == 100 + lng.size());
+    return 0;
+}
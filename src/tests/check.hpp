@@ -0,0 +1,44 @@
+#pragma once
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * Works also when NDEBUG is defined
+ */
+#define STS_CHECK(cond) do{ \
+    if(!(cond)){ \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        std::exit(EXIT_FAILURE); \
+    } \
+} while(false)
+
+/*
+ * Checks that expr throws an exception of type E
+ */
+#define STS_CHECK_THROWS(expr, E) do{ \
+    bool thrown_ = false; \
+    try{ \
+        (void)(expr); \
+    } \
+    catch(E &){ \
+        thrown_ = true; \
+    } \
+    STS_CHECK(thrown_ && #expr); \
+} while(false)
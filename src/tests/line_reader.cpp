@@ -0,0 +1,58 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <strsuite/encmetric.hpp>
+#include <strsuite/io/line_reader.hpp>
+#include "check.hpp"
+
+using namespace sts;
+
+/*
+ * Returns at most step bytes for each read
+ */
+struct string_source{
+    std::string data;
+    size_t pos, step;
+
+    size_t read(byte *b, size_t n){
+        if(pos == data.size())
+            throw IOEOF{};
+        size_t k = std::min({n, step, data.size() - pos});
+        std::memcpy(b, data.data() + pos, k);
+        pos += k;
+        return k;
+    }
+};
+
+int main(){
+    for(size_t step : {1, 2, 4096}){
+        string_source src{"ok\nab\xc3", 0, step};
+        line_reader<UTF8, string_source> reader{src};
+        conditional_result<adv_string_view<UTF8>> line = reader.next();
+        STS_CHECK(line && line.data == u8"ok"_asv);
+        STS_CHECK_THROWS(reader.next(), IOIncomplete);
+    }
+    string_source src{"one\ntwo\xc3\xa8", 0, 3};
+    line_reader<UTF8, string_source> reader{src};
+    STS_CHECK(reader.next().data == u8"one"_asv);
+    STS_CHECK(reader.next().data == u8"twoè"_asv);
+    STS_CHECK(!reader.next());
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <strsuite/encmetric.hpp>
+#include <strsuite/io.hpp>
+#include "check.hpp"
+
+using namespace sts;
+
+int main(){
+    const char *fname = "mapped_file_test.txt";
+    std::FILE *f = std::fopen(fname, "wb");
+    STS_CHECK(f != nullptr);
+    std::fwrite("hello world\n", 1, 12, f);
+    std::fclose(f);
+
+    /*
+     * The file size isn't a multiple of the page size
+     */
+    for(int i=0; i<64; i++){
+        mapped_file m{fname, true};
+        STS_CHECK(m.size() == 12 && m.view<UTF8>() == u8"hello world\n"_asv);
+    }
+    mapped_file plain{fname};
+    STS_CHECK(plain.view<UTF8>().length() == 12);
+    std::remove(fname);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+    This file is part of Encmetric.
+    Copyright (C) 2021 Paolo De Donato.
+
+    Encmetric is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Encmetric is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with Encmetric. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstring>
+#include <vector>
+#include <strsuite/encmetric.hpp>
+#include <strsuite/encmetric/string_column.hpp>
+#include "check.hpp"
+
+using namespace sts;
+using column = string_column<UTF8>;
+
+static std::vector<byte> image_of(const column::image_header &head, size_t extra){
+    std::vector<byte> ret(sizeof(head) + extra);
+    std::memcpy(ret.data(), &head, sizeof(head));
+    return ret;
+}
+
+int main(){
+    column col;
+    col.push_back(u8"pear"_asv);
+    col.push_back(u8"äpple"_asv);
+    col.push_back(u8""_asv);
+    std::vector<byte> img(col.image_size());
+    col.save(img.data());
+    column cp = column::load(img.data(), img.size());
+    STS_CHECK(cp.size() == 3 && cp[1] == u8"äpple"_asv && cp.length(1) == 5);
+
+    /*
+     * Truncated images
+     */
+    for(size_t siz : {size_t{0}, sizeof(column::image_header) - 1, img.size() - 1})
+        STS_CHECK_THROWS(column::load(img.data(), siz), std::out_of_range);
+
+    /*
+     * Header fields that overflow when summed
+     */
+    column::image_header head{column::image_magic, sizeof(std::uint32_t), UINT64_MAX, 0, 0};
+    std::vector<byte> bad = image_of(head, 16);
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+    head.rows = UINT64_MAX / 2;
+    head.has_lengths = 1;
+    bad = image_of(head, 16);
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+    head.rows = 0;
+    head.has_lengths = 0;
+    head.bytes = UINT64_MAX;
+    bad = image_of(head, 16);
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+
+    /*
+     * Wrong magic and offsets out of order
+     */
+    bad = img;
+    bad[0] = byte{0};
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+    bad = img;
+    std::uint32_t off = 100;
+    std::memcpy(bad.data() + sizeof(column::image_header) + sizeof(std::uint32_t), &off, sizeof(off));
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+
+    /*
+     * Cached length bigger than its string
+     */
+    bad = img;
+    std::uint32_t len = 7;
+    std::memcpy(bad.data() + sizeof(column::image_header) + 4 * sizeof(std::uint32_t), &len, sizeof(len));
+    STS_CHECK_THROWS(column::load(bad.data(), bad.size()), std::out_of_range);
+
+    col.append(col);
+    STS_CHECK(col.size() == 6 && col[4] == u8"äpple"_asv);
+    return 0;
+}